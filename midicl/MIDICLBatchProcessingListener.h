@@ -0,0 +1,171 @@
+// MIDICLBatchProcessingListener.h
+
+// GUARD
+
+#ifndef MIDICLBatchProcessingListener_h
+#define MIDICLBatchProcessingListener_h
+
+// INCLUDES
+
+#include "MIDICLInputPortListener.h"
+#include "MIDICLMessage.h"
+#include "MIDICLMessageWriter.h"
+#include "MIDICLPacketListBuilder.h"
+#include "MIDICLParser.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+// FORWARD DECLARATIONS
+
+class MIDICLOutputPort;
+
+// CLASS
+
+// MIDICLProcessingListener for transforms known at compile time
+// T derives from MIDICLBatchProcessingListener<T> and provides
+//
+//		void
+//		Process (const MIDICLMessage *inMessages, UInt32 inCount, MIDICLMessageWriter &ioWriter);
+//
+// which gets each packet's messages in runs of up to kBatchSize, in order
+// as MIDICLParser makes them, so they can start in an earlier packet
+// and writes as many or as few as it likes, the call is resolved at compile time
+// sysex goes straight through unless T hides PassesSysEx() with one that says no
+// parser state and the builder follow one stream of lists, so it listens to one input port
+
+template <class T>
+class MIDICLBatchProcessingListener
+	:
+	public MIDICLInputPortListener
+{
+	// static public constants
+	public:
+
+		static const UInt32	kBatchSize = 64;
+
+	// public constructors/destructor
+	public:
+
+		MIDICLBatchProcessingListener (MIDICLOutputPort *outPort)
+			:
+			mBuilder (outPort)
+		{
+		}
+
+	// MIDICLInputPortListener implementation
+	public:
+
+		void
+		Hear (const MIDIPacketList *inList)
+			// throws MIDICLException
+		{
+			Run (inList, mBuilder);
+
+			mBuilder.Flush ();
+		}
+
+	// public methods
+	public:
+
+		// what Hear() does short of sending, into any builder
+		void
+		Run (const MIDIPacketList *inList, MIDICLPacketListBuilder &ioBuilder);
+			// throws MIDICLException
+
+		// whether sysex goes on, asked of T at compile time
+		static bool
+		PassesSysEx ()
+		{
+			return true;
+		}
+
+	// private types
+	private:
+
+		// what the parser hands each packet's messages to
+		struct Handler
+		{
+			void
+			Message (const MIDICLMessage &inMessage)
+			{
+				mListener->mMessages [mCount++] = inMessage;
+
+				if (mCount == kBatchSize)
+				{
+					Process ();
+				}
+			}
+
+			void
+			SysEx (const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp)
+			{
+				// what came before it goes first
+				Process ();
+
+				if (T::PassesSysEx ())
+				{
+					mWriter->WriteSysEx (inData, inLength, inTimeStamp);
+				}
+			}
+
+			void
+			Process ()
+			{
+				if (mCount > 0)
+				{
+					static_cast<T *> (mListener)->Process (mListener->mMessages, mCount, *mWriter);
+					mCount = 0;
+				}
+			}
+
+			MIDICLBatchProcessingListener *
+			mListener;
+
+			MIDICLMessageWriter *
+			mWriter;
+
+			UInt32
+			mCount;
+		};
+
+	// private data
+	private:
+
+		MIDICLPacketListBuilder
+		mBuilder;
+
+		MIDICLParser
+		mParser;
+
+		MIDICLMessage
+		mMessages [kBatchSize];
+};
+
+// PUBLIC METHODS
+
+template <class T>
+void
+MIDICLBatchProcessingListener<T>::Run (const MIDIPacketList *inList, MIDICLPacketListBuilder &ioBuilder)
+{
+	MIDICLMessageWriter	writer (ioBuilder);
+
+	Handler	handler;
+
+	handler.mListener = this;
+	handler.mWriter = &writer;
+	handler.mCount = 0;
+
+	const MIDIPacket	*packet (inList->packet);
+
+	for (UInt32 p = 0; p < inList->numPackets;
+		p++, packet = MIDIPacketNext (packet))
+	{
+		mParser.Parse (packet->data, packet->length, packet->timeStamp, handler);
+
+		handler.Process ();
+
+		writer.EndPacket ();
+	}
+}
+
+#endif	// MIDICLBatchProcessingListener_h
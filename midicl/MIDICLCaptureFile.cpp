@@ -0,0 +1,157 @@
+// MIDICLCaptureFile.cpp
+
+// INCLUDES
+
+#include "MIDICLCaptureFile.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLCaptureFile::MIDICLCaptureFile ()
+	:
+	mSegmentSize (0),
+	mSegmentCount (0),
+	mSequence (0),
+	mFile (-1),
+	mData (NULL),
+	mLength (0)
+{
+}
+
+MIDICLCaptureFile::~MIDICLCaptureFile ()
+{
+	Close ();
+}
+
+// PUBLIC METHODS
+
+bool
+MIDICLCaptureFile::Open (const char *inPath, UInt32 inSegmentSize, UInt32 inSegmentCount)
+{
+	Close ();
+
+	mPath = inPath;
+	mSegmentSize = inSegmentSize > sizeof (Header) ? inSegmentSize : sizeof (Header) + 4096;
+	mSegmentCount = inSegmentCount > 0 ? inSegmentCount : 1;
+	mSequence = 0;
+
+	return OpenSegment ();
+}
+
+bool
+MIDICLCaptureFile::Write (MIDITimeStamp inTimeStamp, const Byte *inData, UInt16 inLength)
+{
+	if (mData == NULL)
+	{
+		return false;
+	}
+
+	UInt32	recordSize = kRecordHeaderSize + inLength;
+
+	if (sizeof (Header) + recordSize > mSegmentSize)
+	{
+		return false;
+	}
+
+	if (sizeof (Header) + mLength + recordSize > mSegmentSize)
+	{
+		CloseSegment ();
+
+		mSequence++;
+
+		if (!OpenSegment ())
+		{
+			return false;
+		}
+	}
+
+	Byte	*record = mData + sizeof (Header) + mLength;
+
+	memcpy (record, &inTimeStamp, sizeof (inTimeStamp));
+	memcpy (record + sizeof (inTimeStamp), &inLength, sizeof (inLength));
+	memcpy (record + kRecordHeaderSize, inData, inLength);
+
+	mLength += recordSize;
+
+	// kept current, so a crash loses nothing that was written
+	((Header *) mData)->mLength = mLength;
+
+	return true;
+}
+
+void
+MIDICLCaptureFile::Close ()
+{
+	CloseSegment ();
+}
+
+// PRIVATE METHODS
+
+bool
+MIDICLCaptureFile::OpenSegment ()
+{
+	char	path [1024];
+
+	snprintf (path, sizeof (path), "%s.%u", mPath.c_str (), (UInt32) (mSequence % mSegmentCount));
+
+	mFile = open (path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+	if (mFile < 0)
+	{
+		return false;
+	}
+
+	void	*data = MAP_FAILED;
+
+	if (ftruncate (mFile, mSegmentSize) == 0)
+	{
+		data = mmap (NULL, mSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFile, 0);
+	}
+
+	if (data == MAP_FAILED)
+	{
+		close (mFile);
+		mFile = -1;
+
+		return false;
+	}
+
+	mData = (Byte *) data;
+	mLength = 0;
+
+	Header	*header = (Header *) mData;
+
+	memcpy (header->mMagic, "MCAP", 4);
+	header->mVersion = kVersion;
+	header->mSequence = mSequence;
+	header->mLength = 0;
+
+	return true;
+}
+
+void
+MIDICLCaptureFile::CloseSegment ()
+{
+	if (mData != NULL)
+	{
+		munmap (mData, mSegmentSize);
+		mData = NULL;
+
+		// what's after the records was never written
+		// if this doesn't work the header still says how much there is
+		int	result = ftruncate (mFile, sizeof (Header) + mLength);
+
+		(void) result;
+	}
+
+	if (mFile >= 0)
+	{
+		close (mFile);
+		mFile = -1;
+	}
+}
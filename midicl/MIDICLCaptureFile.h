@@ -0,0 +1,137 @@
+// MIDICLCaptureFile.h
+
+// GUARD
+
+#ifndef MIDICLCaptureFile_h
+#define MIDICLCaptureFile_h
+
+// INCLUDES
+
+#include <CoreMIDI/MIDIServices.h>
+
+#include <string>
+
+// CLASS
+
+// packets as they arrived, in a compact binary log written through a memory map
+// the log goes in segments of a fixed size, inPath.0, inPath.1 and so on
+// round to the first again after the last, so it's only ever so big
+//
+// each segment is a Header then records of
+//
+//		UInt64	time stamp
+//		UInt16	length
+//		Byte	data [length]
+//
+// in host order with no padding, mLength in the header says how many bytes of them there are
+
+class MIDICLCaptureFile
+{
+	// public types
+	public:
+
+		struct Header
+		{
+			// "MCAP"
+			char
+			mMagic [4];
+
+			UInt32
+			mVersion;
+
+			// which segment this was, counting every one since Open()
+			UInt64
+			mSequence;
+
+			// of records after the header
+			UInt64
+			mLength;
+		};
+
+	// static public constants
+	public:
+
+		static const UInt32	kVersion = 1;
+
+		// what each record adds to its data
+		static const UInt32	kRecordHeaderSize = 10;
+
+	// public constructors/destructor
+	public:
+
+		MIDICLCaptureFile ();
+
+		~MIDICLCaptureFile ();
+
+	// public methods
+	public:
+
+		// false if the first segment couldn't be made
+		// inSegmentSize is a limit, a record that can't fit in an empty segment isn't written
+		bool
+		Open (const char *inPath, UInt32 inSegmentSize, UInt32 inSegmentCount);
+
+		// false if it wasn't written, with the file still open if the record was too big for a segment
+		// and closed from then on if it couldn't be written at all
+		bool
+		Write (MIDITimeStamp inTimeStamp, const Byte *inData, UInt16 inLength);
+
+		// trims the segment to what's in it
+		void
+		Close ();
+
+		bool
+		IsOpen () const
+		{
+			return mData != NULL;
+		}
+
+	// private methods
+	private:
+
+		bool
+		OpenSegment ();
+
+		void
+		CloseSegment ();
+
+	// private constructors
+	private:
+
+		MIDICLCaptureFile (const MIDICLCaptureFile &inCopy);
+
+	// private operators overloaded
+	private:
+
+		MIDICLCaptureFile &
+		operator = (const MIDICLCaptureFile &inCopy);
+
+	// private data
+	private:
+
+		std::string
+		mPath;
+
+		UInt32
+		mSegmentSize;
+
+		UInt32
+		mSegmentCount;
+
+		// counting every one, not wrapped round
+		UInt64
+		mSequence;
+
+		int
+		mFile;
+
+		// NULL while closed
+		Byte *
+		mData;
+
+		// of records in this segment
+		UInt64
+		mLength;
+};
+
+#endif	// MIDICLCaptureFile_h
@@ -6,12 +6,22 @@
 
 #include "MIDICLOutputPort.h"
 
+#include <string.h>
+
+// TYPES
+
+// 16 bytes worked on at once, which the compiler makes SSE or NEON
+typedef Byte
+Bytes16 __attribute__ ((vector_size (16)));
+
 // PUBLIC CONSTRUCTORS/DESTRUCTOR
 
 MIDICLChannelisingListener::MIDICLChannelisingListener
 	(MIDICLOutputPort *outPort)
 	:
-	mOutputPort (outPort)
+	mBuilder (outPort),
+	mFromChannel (kAnyChannel),
+	mToChannel (kNoChannel)
 {
 }
 
@@ -20,82 +30,41 @@ MIDICLChannelisingListener::MIDICLChannelisingListener
 void
 MIDICLChannelisingListener::Hear (const MIDIPacketList *inPacketList)
 {
-	Byte	outputPacketListBuffer [300];
-	Byte	outputPacketBuffer [300];
+	Run (inPacketList, mBuilder);
 
-	MIDIPacketList	*outputPacketList
-		((MIDIPacketList *) outputPacketListBuffer);
+	// send whatever remains
+	mBuilder.Flush ();
+}
 
-	MIDIPacket	*outputPacket
-		(MIDIPacketListInit (outputPacketList));
+// PUBLIC METHODS
 
+void
+MIDICLChannelisingListener::Run (const MIDIPacketList *inPacketList, MIDICLPacketListBuilder &ioBuilder)
+{
 	const MIDIPacket	*inputPacket (inPacketList->packet);
 
 	for (UInt32	p = 0; p < inPacketList->numPackets;
 		p++, inputPacket = MIDIPacketNext (inputPacket))
 	{
+		Byte	*outputPacketBuffer = ioBuilder.Reserve (inputPacket->length);
+
 		// copy & maybe channelise
-		for (UInt16 i = 0; i < inputPacket->length; i++)
-		{
-			if (inputPacket->data [i] >= 0x80
-				&& inputPacket->data [i] < 0xf0)
-			{
-				printf ("got status byte %02x \n", 
-					inputPacket->data [i] & 0xff);
-
-				// status byte
-				// does the channel match?
-				if (mFromChannel == 0
-					|| (inputPacket->data [i] & 0xf) == mFromChannel)
-				{
-					outputPacketBuffer [i]
-						= (inputPacket->data [i] & 0xf0) | mToChannel;
-				}
-				else
-				{
-					outputPacketBuffer [i] = inputPacket->data [i];
-				}
-			}
-			else
-			{
-				outputPacketBuffer [i] = inputPacket->data [i];
-			}
-		}
+		Remap (inputPacket->data, outputPacketBuffer, inputPacket->length);
 
-		do
-		{
-			outputPacket = MIDIPacketListAdd
-				(outputPacketList, sizeof (outputPacketListBuffer),
-					outputPacket, 0, inputPacket->length, outputPacketBuffer);
-
-			if (outputPacket == NULL)
-			{
-				// send what we have
-				mOutputPort->SendPacketList (outputPacketList);
-
-				// reinitialise the packet list
-				outputPacket = MIDIPacketListInit (outputPacketList);
-			}
-		}
-		while (outputPacket == NULL);
+		ioBuilder.Commit (0, inputPacket->length);
 	}
-
-	// send whatever remains
-	mOutputPort->SendPacketList (outputPacketList);
 }
 
-// PUBLIC METHODS
-
 void
 MIDICLChannelisingListener::SetFromChannel (Byte inChannel)
 {
 	if (inChannel >= 1 && inChannel <= 16)
 	{
-		mFromChannel = inChannel;
+		mFromChannel = inChannel - 1;
 	}
 	else
 	{
-		mFromChannel = 0;
+		mFromChannel = kAnyChannel;
 	}
 }
 
@@ -104,8 +73,54 @@ MIDICLChannelisingListener::SetToChannel (Byte inChannel)
 {
 	if (inChannel >= 1 && inChannel <= 16)
 	{
-		mToChannel = inChannel;
+		mToChannel = inChannel - 1;
 	}
 }
 
+// PRIVATE METHODS
+
+void
+MIDICLChannelisingListener::Remap (const Byte *inData, Byte *outData, UInt16 inLength) const
+{
+	if (mToChannel == kNoChannel)
+	{
+		memcpy (outData, inData, inLength);
+		return;
+	}
+
+	UInt16	i = 0;
+
+	// channel statuses are 0x80 to 0xef, everything else goes as it is
+	// all lanes set where the byte is one to move
+	for (; i + sizeof (Bytes16) <= inLength; i += sizeof (Bytes16))
+	{
+		Bytes16	bytes;
+
+		memcpy (&bytes, inData + i, sizeof (bytes));
+
+		Bytes16	move = (Bytes16) (bytes >= 0x80) & (Bytes16) (bytes < 0xf0);
+
+		if (mFromChannel != kAnyChannel)
+		{
+			move &= (Bytes16) ((bytes & 0x0f) == mFromChannel);
+		}
+
+		bytes = (bytes & ~move) | (((bytes & 0xf0) | mToChannel) & move);
+
+		memcpy (outData + i, &bytes, sizeof (bytes));
+	}
+
+	// the end of the packet
+	for (; i < inLength; i++)
+	{
+		Byte	byte = inData [i];
+
+		if (byte >= 0x80 && byte < 0xf0
+			&& (mFromChannel == kAnyChannel || (byte & 0x0f) == mFromChannel))
+		{
+			byte = (byte & 0xf0) | mToChannel;
+		}
 
+		outData [i] = byte;
+	}
+}
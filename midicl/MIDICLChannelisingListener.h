@@ -8,6 +8,7 @@
 // INCLUDES
 
 #include "MIDICLInputPortListener.h"
+#include "MIDICLPacketListBuilder.h"
 
 #include <CoreMIDI/MIDIServices.h>
 
@@ -18,6 +19,11 @@ struct MIDIPacketList;
 
 // CLASS
 
+// moves channel messages from one channel, or any, to another
+// only status bytes change, so each byte can be done without knowing what came before it
+// and whole runs of a packet are done 16 at a time
+// it builds its lists in one builder, so like a MIDICLProcessingListener it listens to one input port
+
 class MIDICLChannelisingListener
 	:
 	public MIDICLInputPortListener
@@ -32,10 +38,16 @@ class MIDICLChannelisingListener
 
 		void
 		Hear (const MIDIPacketList *inList);
+			// throws MIDICLException
 
 	// public methods
 	public:
 
+		// what Hear() does short of sending, into any builder
+		void
+		Run (const MIDIPacketList *inList, MIDICLPacketListBuilder &ioBuilder);
+			// throws MIDICLException
+
 		// anything out of the range 1-16
 		// is taken to mean "any channel"
 		void
@@ -43,18 +55,36 @@ class MIDICLChannelisingListener
 
 		// anything out of the range 1-16
 		// is ignored (no config change)
+		// until one is set everything passes through unchanged
 		void
 		SetToChannel (Byte inChannel);
 
+	// static private constants
+	private:
+
+		// in mFromChannel and mToChannel
+		static const Byte	kAnyChannel = 0xff;
+		static const Byte	kNoChannel = 0xff;
+
+	// private methods
+	private:
+
+		// inLength bytes, 16 at a time then one at a time for the rest
+		void
+		Remap (const Byte *inData, Byte *outData, UInt16 inLength) const;
+
 	// private data
 	private:
 
-		MIDICLOutputPort *
-		mOutputPort;
+		// only Hear() uses it, for the one port
+		MIDICLPacketListBuilder
+		mBuilder;
 
+		// 0-15, or kAnyChannel
 		Byte
 		mFromChannel;
 
+		// 0-15, or kNoChannel
 		Byte
 		mToChannel;
 };
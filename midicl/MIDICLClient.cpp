@@ -40,6 +40,9 @@ MIDICLClient::kMIDIStartSysExMessage = 0xf0;
 const int
 MIDICLClient::kMIDIStopSysExMessage = 0xf7;
 
+const int
+MIDICLClient::kMIDISongPositionMessage = 0xf2;
+
 const int
 MIDICLClient::kMIDIClockMessage = 0xf8;
 
@@ -49,6 +49,9 @@ class MIDICLClient
 		static const int
 		kMIDIStopSysExMessage;
 
+		static const int
+		kMIDISongPositionMessage;
+
 		static const int
 		kMIDIClockMessage;
 
@@ -12,8 +12,6 @@
 MIDICLDestination::MIDICLDestination
 	(MIDIClientRef inClientRef, CFStringRef inName)
 	// throws MIDICLException
-	:
-	mListener (NULL)
 {
 	OSStatus	errCode = MIDIDestinationCreate
 		(inClientRef, inName, ReadProc, this, &mDestinationRef);
@@ -32,10 +30,22 @@ MIDICLDestination::~MIDICLDestination ()
 
 // PUBLIC METHODS
 
+void
+MIDICLDestination::AddListener (MIDICLInputPortListener *inListener)
+{
+	mListeners.Add (inListener);
+}
+
+void
+MIDICLDestination::RemoveListener (MIDICLInputPortListener *inListener)
+{
+	mListeners.Remove (inListener);
+}
+
 void
 MIDICLDestination::SetListener (MIDICLInputPortListener *inListener)
 {
-	mListener = inListener;
+	mListeners.Set (inListener);
 }
 
 #if 0
@@ -56,9 +66,6 @@ MIDICLDestination::ReadProc
 	MIDICLDestination	*self ((MIDICLDestination *) inReadProcRefCon);
 
 	// notify listeners
-	if (self->mListener != NULL)
-	{
-		self->mListener->Hear (inList);
-	}
+	self->mListeners.Hear (inList);
 }
 
@@ -7,6 +7,8 @@
 
 // INCLUDES
 
+#include "MIDICLListenerSet.h"
+
 #include <CoreMIDI/CoreMIDI.h>
 
 // FORWARD DECLARATIONS
@@ -26,6 +28,15 @@ class MIDICLDestination
 	// public methods
 	public:
 
+		// every listener hears the same packet list, in the order they were added
+		// safe while the destination is hearing things, see MIDICLListenerSet
+		void
+		AddListener (MIDICLInputPortListener *inListener);
+
+		void
+		RemoveListener (MIDICLInputPortListener *inListener);
+
+		// just this one, or none if it's NULL
 		void
 		SetListener (MIDICLInputPortListener *inListener);
 
@@ -50,8 +61,8 @@ class MIDICLDestination
 	// private data
 	private:
 
-		MIDICLInputPortListener *
-		mListener;
+		MIDICLListenerSet
+		mListeners;
 
 		MIDIEndpointRef
 		mDestinationRef;
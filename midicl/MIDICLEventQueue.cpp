@@ -0,0 +1,114 @@
+// MIDICLEventQueue.cpp
+
+// INCLUDES
+
+#include "MIDICLEventQueue.h"
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLEventQueue::MIDICLEventQueue (UInt32 inCapacity)
+	:
+	mSlots (NULL),
+	mMask (0),
+	mWrite (0),
+	mRead (0)
+{
+	UInt32	capacity = 2;
+
+	while (capacity < inCapacity && capacity < 0x80000000)
+	{
+		capacity <<= 1;
+	}
+
+	mSlots = new Slot [capacity];
+	mMask = capacity - 1;
+
+	for (UInt32 i = 0; i < capacity; i++)
+	{
+		mSlots [i].mSequence.store (i, std::memory_order_relaxed);
+	}
+
+	for (UInt32 i = 0; i < kMaximumSources; i++)
+	{
+		mDropped [i].store (0, std::memory_order_relaxed);
+	}
+}
+
+MIDICLEventQueue::~MIDICLEventQueue ()
+{
+	delete [] mSlots;
+}
+
+// PUBLIC METHODS
+
+bool
+MIDICLEventQueue::Push (const Event &inEvent)
+{
+	UInt32	write = mWrite.load (std::memory_order_relaxed);
+	Slot		*slot = NULL;
+
+	for (;;)
+	{
+		slot = &mSlots [write & mMask];
+
+		SInt32	difference = (SInt32) (slot->mSequence.load (std::memory_order_acquire) - write);
+
+		if (difference == 0)
+		{
+			// ours if nobody else got there first, otherwise write is theirs now and we go again
+			if (mWrite.compare_exchange_weak (write, write + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (difference < 0)
+		{
+			// the consumer hasn't finished with this slot from last time round
+			mDropped [SourceIndex (inEvent.mSource)].fetch_add (1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			// another producer took it
+			write = mWrite.load (std::memory_order_relaxed);
+		}
+	}
+
+	slot->mEvent = inEvent;
+	slot->mSequence.store (write + 1, std::memory_order_release);
+
+	return true;
+}
+
+bool
+MIDICLEventQueue::Pop (Event &outEvent)
+{
+	Slot	&slot = mSlots [mRead & mMask];
+
+	// claimed but not written yet counts as empty, the rest wait behind it
+	if (slot.mSequence.load (std::memory_order_acquire) != mRead + 1)
+	{
+		return false;
+	}
+
+	outEvent = slot.mEvent;
+
+	// free for the write index one lap on
+	slot.mSequence.store (mRead + mMask + 1, std::memory_order_release);
+	mRead++;
+
+	return true;
+}
+
+UInt32
+MIDICLEventQueue::GetDroppedCount () const
+{
+	UInt32	dropped = 0;
+
+	for (UInt32 i = 0; i < kMaximumSources; i++)
+	{
+		dropped += mDropped [i].load (std::memory_order_relaxed);
+	}
+
+	return dropped;
+}
@@ -0,0 +1,155 @@
+// MIDICLEventQueue.h
+
+// GUARD
+
+#ifndef MIDICLEventQueue_h
+#define MIDICLEventQueue_h
+
+// INCLUDES
+
+#include "MIDICLMessage.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+#include <atomic>
+
+// CLASS
+
+// a bounded queue of fixed size events from any number of threads to one
+// so every input port's read proc can hand messages to the one thread that acts on them
+// Push() and Pop() never wait, lock or allocate
+// each slot carries a sequence number saying whose turn it is, producers race for the write index
+// what arrives with the queue full is dropped and counted against its source
+
+class MIDICLEventQueue
+{
+	// static public constants
+	public:
+
+		// sources past this are counted with the last
+		static const UInt32	kMaximumSources = 16;
+
+	// public types
+	public:
+
+		struct Event
+		{
+			MIDICLMessage
+			mMessage;
+
+			// whatever the producer says it is, 0 to kMaximumSources - 1 for the counts
+			UInt32
+			mSource;
+		};
+
+	// public constructors/destructor
+	public:
+
+		// inCapacity is rounded up to a power of two
+		MIDICLEventQueue (UInt32 inCapacity = 1024);
+
+		~MIDICLEventQueue ();
+
+	// public methods
+	public:
+
+		// from any thread, false if the queue was full
+		bool
+		Push (const Event &inEvent);
+
+		// from the one consumer thread, false if there's nothing waiting
+		bool
+		Pop (Event &outEvent);
+
+		// from the consumer, hands F's
+		//
+		//		void
+		//		operator () (const Event &inEvent);
+		//
+		// what's there now, not what arrives while it's going
+		// returns how many that was
+		template <class F> UInt32
+		Drain (F &ioHandler)
+		{
+			UInt32	count = 0;
+			Event		event;
+
+			while (count <= mMask && Pop (event))
+			{
+				ioHandler (event);
+				count++;
+			}
+
+			return count;
+		}
+
+		UInt32
+		GetCapacity () const
+		{
+			return mMask + 1;
+		}
+
+		UInt32
+		GetDroppedCount () const;
+
+		UInt32
+		GetDroppedCount (UInt32 inSource) const
+		{
+			return mDropped [SourceIndex (inSource)].load (std::memory_order_relaxed);
+		}
+
+	// private types
+	private:
+
+		struct Slot
+		{
+			// the write index this slot is free for, or that plus one once it's full
+			std::atomic<UInt32>
+			mSequence;
+
+			Event
+			mEvent;
+		};
+
+	// static private methods
+	private:
+
+		static UInt32
+		SourceIndex (UInt32 inSource)
+		{
+			return inSource < kMaximumSources ? inSource : kMaximumSources - 1;
+		}
+
+	// private constructors
+	private:
+
+		MIDICLEventQueue (const MIDICLEventQueue &inCopy);
+
+	// private operators overloaded
+	private:
+
+		MIDICLEventQueue &
+		operator = (const MIDICLEventQueue &inCopy);
+
+	// private data
+	private:
+
+		Slot *
+		mSlots;
+
+		UInt32
+		mMask;
+
+		// free running, apart so the producers and the consumer don't share a line
+		alignas (64) std::atomic<UInt32>
+		mWrite;
+
+		// the consumer's alone
+		alignas (64) UInt32
+		mRead;
+
+		alignas (64) std::atomic<UInt32>
+		mDropped [kMaximumSources];
+};
+
+#endif	// MIDICLEventQueue_h
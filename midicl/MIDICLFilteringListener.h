@@ -0,0 +1,73 @@
+// MIDICLFilteringListener.h
+
+// GUARD
+
+#ifndef MIDICLFilteringListener_h
+#define MIDICLFilteringListener_h
+
+// INCLUDES
+
+#include "MIDICLBatchProcessingListener.h"
+#include "MIDICLMessage.h"
+#include "MIDICLMessageWriter.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+// FORWARD DECLARATIONS
+
+class MIDICLOutputPort;
+
+// CLASS
+
+// passes on what F passes, F being a MIDICLMessageFilter or anything else with
+//
+//		static bool
+//		Passes (const MIDICLMessage &inMessage);
+//
+// sysex, every piece of it, goes through if F passes status 0xf0
+
+template <class F>
+class MIDICLFilteringListener
+	:
+	public MIDICLBatchProcessingListener<MIDICLFilteringListener<F> >
+{
+	// public constructors/destructor
+	public:
+
+		MIDICLFilteringListener (MIDICLOutputPort *outPort)
+			:
+			MIDICLBatchProcessingListener<MIDICLFilteringListener<F> > (outPort)
+		{
+		}
+
+	// MIDICLBatchProcessingListener implementation
+	public:
+
+		void
+		Process (const MIDICLMessage *inMessages, UInt32 inCount, MIDICLMessageWriter &ioWriter)
+		{
+			for (UInt32 i = 0; i < inCount; i++)
+			{
+				if (F::Passes (inMessages [i]))
+				{
+					ioWriter.Write (inMessages [i]);
+				}
+			}
+		}
+
+		static bool
+		PassesSysEx ()
+		{
+			MIDICLMessage	message;
+
+			message.mTimeStamp = 0;
+			message.mStatus = 0xf0;
+			message.mData [0] = 0;
+			message.mData [1] = 0;
+			message.mDataLength = 0;
+
+			return F::Passes (message);
+		}
+};
+
+#endif	// MIDICLFilteringListener_h
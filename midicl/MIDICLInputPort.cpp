@@ -12,8 +12,6 @@
 MIDICLInputPort::MIDICLInputPort
 	(MIDIClientRef inClientRef, CFStringRef inName)
 	// throws MIDICLException
-	:
-	mListener (NULL)
 {
 	OSStatus	errCode = MIDIInputPortCreate
 		(inClientRef, inName, ReadProc, this, &mPortRef);
@@ -32,10 +30,22 @@ MIDICLInputPort::~MIDICLInputPort ()
 
 // PUBLIC METHODS
 
+void
+MIDICLInputPort::AddListener (MIDICLInputPortListener *inListener)
+{
+	mListeners.Add (inListener);
+}
+
+void
+MIDICLInputPort::RemoveListener (MIDICLInputPortListener *inListener)
+{
+	mListeners.Remove (inListener);
+}
+
 void
 MIDICLInputPort::SetListener (MIDICLInputPortListener *inListener)
 {
-	mListener = inListener;
+	mListeners.Set (inListener);
 }
 
 void
@@ -54,9 +64,6 @@ MIDICLInputPort::ReadProc
 	MIDICLInputPort	*self ((MIDICLInputPort *) inReadProcRefCon);
 
 	// notify listeners
-	if (self->mListener != NULL)
-	{
-		self->mListener->Hear (inList);
-	}
+	self->mListeners.Hear (inList);
 }
 
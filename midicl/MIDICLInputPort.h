@@ -7,6 +7,8 @@
 
 // INCLUDES
 
+#include "MIDICLListenerSet.h"
+
 #include <CoreMIDI/CoreMIDI.h>
 
 // FORWARD DECLARATIONS
@@ -26,6 +28,15 @@ class MIDICLInputPort
 	// public methods
 	public:
 
+		// every listener hears the same packet list, in the order they were added
+		// safe while the port is hearing things, see MIDICLListenerSet
+		void
+		AddListener (MIDICLInputPortListener *inListener);
+
+		void
+		RemoveListener (MIDICLInputPortListener *inListener);
+
+		// just this one, or none if it's NULL
 		void
 		SetListener (MIDICLInputPortListener *inListener);
 
@@ -53,8 +64,8 @@ class MIDICLInputPort
 	// private data
 	private:
 
-		MIDICLInputPortListener *
-		mListener;
+		MIDICLListenerSet
+		mListeners;
 
 		MIDIPortRef
 		mPortRef;
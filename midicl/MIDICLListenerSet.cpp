@@ -0,0 +1,143 @@
+// MIDICLListenerSet.cpp
+
+// INCLUDES
+
+#include "MIDICLListenerSet.h"
+
+#include <algorithm>
+#include <thread>
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLListenerSet::MIDICLListenerSet ()
+	:
+	mSnapshot (new Snapshot ()),
+	mEpoch (0)
+{
+	mReaders [0] = 0;
+	mReaders [1] = 0;
+}
+
+MIDICLListenerSet::~MIDICLListenerSet ()
+{
+	delete mSnapshot.load ();
+}
+
+// MIDICLINPUTPORTLISTENER IMPLEMENTATION
+
+void
+MIDICLListenerSet::Hear (const MIDIPacketList *inList)
+{
+	UInt32	epoch = mEpoch.load ();
+
+	// counted in an epoch before Publish() moved on would go unwaited for, so look again
+	for (;;)
+	{
+		mReaders [epoch & 1]++;
+
+		UInt32	now = mEpoch.load ();
+
+		if (now == epoch)
+		{
+			break;
+		}
+
+		mReaders [epoch & 1]--;
+		epoch = now;
+	}
+
+	const Snapshot	*snapshot = mSnapshot.load ();
+
+	try
+	{
+		for (MIDICLInputPortListener *listener : *snapshot)
+		{
+			listener->Hear (inList);
+		}
+	}
+	catch (...)
+	{
+		mReaders [epoch & 1]--;
+		throw;
+	}
+
+	mReaders [epoch & 1]--;
+}
+
+// PUBLIC METHODS
+
+void
+MIDICLListenerSet::Add (MIDICLInputPortListener *inListener)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	const Snapshot	*snapshot = mSnapshot.load ();
+
+	if (std::find (snapshot->begin (), snapshot->end (), inListener) == snapshot->end ())
+	{
+		Snapshot	*added = new Snapshot (*snapshot);
+
+		added->push_back (inListener);
+
+		Publish (added);
+	}
+}
+
+void
+MIDICLListenerSet::Remove (MIDICLInputPortListener *inListener)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	const Snapshot	*snapshot = mSnapshot.load ();
+
+	if (std::find (snapshot->begin (), snapshot->end (), inListener) != snapshot->end ())
+	{
+		Snapshot	*removed = new Snapshot (*snapshot);
+
+		removed->erase (std::find (removed->begin (), removed->end (), inListener));
+
+		Publish (removed);
+	}
+}
+
+void
+MIDICLListenerSet::Set (MIDICLInputPortListener *inListener)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	Snapshot	*snapshot = new Snapshot ();
+
+	if (inListener != NULL)
+	{
+		snapshot->push_back (inListener);
+	}
+
+	Publish (snapshot);
+}
+
+UInt32
+MIDICLListenerSet::GetCount () const
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	return mSnapshot.load ()->size ();
+}
+
+// PRIVATE METHODS
+
+void
+MIDICLListenerSet::Publish (Snapshot *inSnapshot)
+{
+	const Snapshot	*old = mSnapshot.exchange (inSnapshot);
+
+	// a Hear() that starts from here on counts in the new epoch and sees the new snapshot
+	// so once the old epoch's count is down to nothing, nothing has the old one
+	UInt32	epoch = mEpoch++;
+
+	while (mReaders [epoch & 1] != 0)
+	{
+		std::this_thread::yield ();
+	}
+
+	delete old;
+}
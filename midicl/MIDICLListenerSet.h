@@ -0,0 +1,106 @@
+// MIDICLListenerSet.h
+
+// GUARD
+
+#ifndef MIDICLListenerSet_h
+#define MIDICLListenerSet_h
+
+// INCLUDES
+
+#include "MIDICLInputPortListener.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// CLASS
+
+// any number of listeners hearing the same packet list, the very one the port was given
+// Hear() reads an immutable snapshot of the set, taking no lock and allocating nothing
+// Add() and Remove() publish a new snapshot and wait for any Hear() still reading the old one
+// so once Remove() returns the listener won't be called again and can go
+// which means they mustn't be called from a listener's Hear()
+
+class MIDICLListenerSet
+	:
+	public MIDICLInputPortListener
+{
+	// public constructors/destructor
+	public:
+
+		MIDICLListenerSet ();
+
+		~MIDICLListenerSet ();
+
+	// MIDICLInputPortListener implementation
+	public:
+
+		void
+		Hear (const MIDIPacketList *inList);
+			// throws MIDICLException
+
+	// public methods
+	public:
+
+		// once only, adding one that's there already does nothing
+		void
+		Add (MIDICLInputPortListener *inListener);
+
+		// removing one that isn't there does nothing
+		void
+		Remove (MIDICLInputPortListener *inListener);
+
+		// just inListener, or none if it's NULL
+		void
+		Set (MIDICLInputPortListener *inListener);
+
+		UInt32
+		GetCount () const;
+
+	// private types
+	private:
+
+		typedef std::vector<MIDICLInputPortListener *>
+		Snapshot;
+
+	// private methods
+	private:
+
+		// with mMutex held, takes ownership
+		void
+		Publish (Snapshot *inSnapshot);
+
+	// private constructors
+	private:
+
+		MIDICLListenerSet (const MIDICLListenerSet &inCopy);
+
+	// private operators overloaded
+	private:
+
+		MIDICLListenerSet &
+		operator = (const MIDICLListenerSet &inCopy);
+
+	// private data
+	private:
+
+		// writers only
+		mutable std::mutex
+		mMutex;
+
+		// never changed once published
+		std::atomic<const Snapshot *>
+		mSnapshot;
+
+		// which of mReaders a Hear() starting now counts itself in
+		std::atomic<UInt32>
+		mEpoch;
+
+		// Hear()s in progress in each epoch
+		std::atomic<UInt32>
+		mReaders [2];
+};
+
+#endif	// MIDICLListenerSet_h
@@ -0,0 +1,35 @@
+// MIDICLMessage.h
+
+// GUARD
+
+#ifndef MIDICLMessage_h
+#define MIDICLMessage_h
+
+// INCLUDES
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// one complete message other than sysex, with its status even if it arrived in running status
+// as MIDICLParser makes them
+
+struct MIDICLMessage
+{
+	// public data
+
+		MIDITimeStamp
+		mTimeStamp;
+
+		Byte
+		mStatus;
+
+		Byte
+		mData [2];
+
+		// how many of mData there are
+		Byte
+		mDataLength;
+};
+
+#endif	// MIDICLMessage_h
@@ -0,0 +1,141 @@
+// MIDICLMessageFilter.h
+
+// GUARD
+
+#ifndef MIDICLMessageFilter_h
+#define MIDICLMessageFilter_h
+
+// INCLUDES
+
+#include "MIDICLMessage.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// passes or blocks messages by what's fixed in its parameters, which make its tables at compile time
+//
+//		kChannels				bit n passes channel n, 0-15
+//		kMessages				bit n passes status 0x80 + n * 0x10, bit 7 is everything system, sysex included
+//		kLowKey, kHighKey		the keys of note offs, note ons and poly aftertouch that pass
+//		kControllers...			bit n of the low word, then the high, passes controller n
+//
+// Passes() is a look up of the status, then of the first data byte in the mask the status picks
+// with no branches, so a filter costs the same whatever it's set to
+// as in
+//
+//		// the bottom of the keyboard on channel 1, and nothing else
+//		typedef MIDICLMessageFilter<0x0001, 0x03, 0, 59>	LeftHand;
+
+template <UInt16 kChannels = 0xffff, Byte kMessages = 0xff, Byte kLowKey = 0, Byte kHighKey = 127,
+	UInt64 kLowControllers = ~0ULL, UInt64 kHighControllers = ~0ULL>
+class MIDICLMessageFilter
+{
+	// static public constants
+	public:
+
+		// what the status says to do with the data
+		enum
+		{
+			kBlock,
+			kPass,
+			kCheckKey,
+			kCheckController,
+			kClassCount
+		};
+
+	// public types
+	public:
+
+		struct ClassTable
+		{
+			Byte	mClasses [256];
+		};
+
+	// static public methods
+	public:
+
+		static bool
+		Passes (const MIDICLMessage &inMessage)
+		{
+			Byte	data = inMessage.mData [0] & 0x7f;
+
+			return (kDataMasks [kClasses.mClasses [inMessage.mStatus]][data >> 6] >> (data & 63)) & 1;
+		}
+
+		static constexpr Byte
+		Classify (unsigned inStatus)
+		{
+			return inStatus < 0x80 ? kBlock
+				: inStatus >= 0xf0 ? (kMessages & 0x80 ? kPass : kBlock)
+				: ((kMessages >> ((inStatus >> 4) - 8)) & 1) == 0 || ((kChannels >> (inStatus & 0xf)) & 1) == 0 ? kBlock
+				: inStatus < 0xb0 ? kCheckKey
+				: (inStatus & 0xf0) == 0xb0 ? kCheckController
+				: kPass;
+		}
+
+	// static private methods
+	private:
+
+		// the lowest inCount bits
+		static constexpr UInt64
+		Ones (int inCount)
+		{
+			return inCount <= 0 ? 0 : inCount >= 64 ? ~0ULL : (1ULL << inCount) - 1;
+		}
+
+		// the keys kLowKey to kHighKey in the 64 starting at inFirst
+		static constexpr UInt64
+		KeyBits (int inFirst)
+		{
+			return Ones (kHighKey + 1 - inFirst) & ~Ones (kLowKey - inFirst);
+		}
+
+		template <unsigned... I> struct Indices
+		{
+		};
+
+		template <unsigned N, unsigned... I> struct MakeIndices
+			:
+			MakeIndices<N - 1, N - 1, I...>
+		{
+		};
+
+		template <unsigned... I> struct MakeIndices<0, I...>
+		{
+			typedef Indices<I...>	Type;
+		};
+
+		template <unsigned... I> static constexpr ClassTable
+		MakeClasses (Indices<I...>)
+		{
+			return ClassTable { { Classify (I)... } };
+		}
+
+	// static private data
+	private:
+
+		static const ClassTable	kClasses;
+
+		// per class, keys or controllers 0-63 then 64-127
+		static const UInt64	kDataMasks [kClassCount][2];
+};
+
+// STATIC PRIVATE DATA
+
+template <UInt16 kChannels, Byte kMessages, Byte kLowKey, Byte kHighKey, UInt64 kLowControllers, UInt64 kHighControllers>
+const typename MIDICLMessageFilter<kChannels, kMessages, kLowKey, kHighKey, kLowControllers, kHighControllers>::ClassTable
+MIDICLMessageFilter<kChannels, kMessages, kLowKey, kHighKey, kLowControllers, kHighControllers>::kClasses
+	= MakeClasses (typename MakeIndices<256>::Type ());
+
+template <UInt16 kChannels, Byte kMessages, Byte kLowKey, Byte kHighKey, UInt64 kLowControllers, UInt64 kHighControllers>
+const UInt64
+MIDICLMessageFilter<kChannels, kMessages, kLowKey, kHighKey, kLowControllers, kHighControllers>::kDataMasks [kClassCount][2] =
+{
+	{ 0, 0 },
+	{ ~0ULL, ~0ULL },
+	{ KeyBits (0), KeyBits (64) },
+	{ kLowControllers, kHighControllers }
+};
+
+#endif	// MIDICLMessageFilter_h
@@ -0,0 +1,87 @@
+// MIDICLMessageWriter.cpp
+
+// INCLUDES
+
+#include "MIDICLMessageWriter.h"
+
+#include "MIDICLPacketListBuilder.h"
+
+#include <string.h>
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLMessageWriter::MIDICLMessageWriter (MIDICLPacketListBuilder &ioBuilder)
+	:
+	mBuilder (ioBuilder),
+	mPacket (NULL),
+	mLength (0),
+	mTimeStamp (0),
+	mStatus (0)
+{
+}
+
+MIDICLMessageWriter::~MIDICLMessageWriter ()
+{
+	EndPacket ();
+}
+
+// PUBLIC METHODS
+
+void
+MIDICLMessageWriter::Write (const MIDICLMessage &inMessage)
+{
+	if (mPacket != NULL
+		&& (mLength + 1 + inMessage.mDataLength > kPacketSize || inMessage.mTimeStamp != mTimeStamp))
+	{
+		EndPacket ();
+	}
+
+	if (mPacket == NULL)
+	{
+		mPacket = mBuilder.Reserve (kPacketSize);
+		mTimeStamp = inMessage.mTimeStamp;
+	}
+
+	if (inMessage.mStatus >= 0xf8)
+	{
+		// real time leaves running status be
+		mPacket [mLength++] = inMessage.mStatus;
+		return;
+	}
+
+	if (inMessage.mStatus != mStatus)
+	{
+		mPacket [mLength++] = inMessage.mStatus;
+
+		// system common cancels it
+		mStatus = inMessage.mStatus < 0xf0 ? inMessage.mStatus : 0;
+	}
+
+	for (Byte i = 0; i < inMessage.mDataLength; i++)
+	{
+		mPacket [mLength++] = inMessage.mData [i];
+	}
+}
+
+void
+MIDICLMessageWriter::WriteSysEx (const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp)
+{
+	EndPacket ();
+
+	memcpy (mBuilder.Reserve (inLength), inData, inLength);
+
+	mBuilder.Commit (inTimeStamp, inLength);
+}
+
+void
+MIDICLMessageWriter::EndPacket ()
+{
+	if (mPacket != NULL && mLength > 0)
+	{
+		mBuilder.Commit (mTimeStamp, mLength);
+	}
+
+	mPacket = NULL;
+	mLength = 0;
+	mStatus = 0;
+}
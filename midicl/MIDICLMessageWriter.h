@@ -0,0 +1,87 @@
+// MIDICLMessageWriter.h
+
+// GUARD
+
+#ifndef MIDICLMessageWriter_h
+#define MIDICLMessageWriter_h
+
+// INCLUDES
+
+#include "MIDICLMessage.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+// FORWARD DECLARATIONS
+
+class MIDICLPacketListBuilder;
+
+// CLASS
+
+// writes messages into a builder's packets, in running status where it can
+// a packet goes in to the list at EndPacket(), when it's full
+// or when a message comes with a different time stamp, which starts the next
+// sysex gets packets of its own
+
+class MIDICLMessageWriter
+{
+	// static public constants
+	public:
+
+		static const UInt32	kPacketSize = 256;
+
+	// public constructors/destructor
+	public:
+
+		MIDICLMessageWriter (MIDICLPacketListBuilder &ioBuilder);
+
+		// ends the packet in progress
+		~MIDICLMessageWriter ();
+
+	// public methods
+	public:
+
+		void
+		Write (const MIDICLMessage &inMessage);
+			// throws MIDICLException
+
+		void
+		WriteSysEx (const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp);
+			// throws MIDICLException
+
+		void
+		EndPacket ();
+
+	// private constructors
+	private:
+
+		MIDICLMessageWriter (const MIDICLMessageWriter &inCopy);
+
+	// private operators overloaded
+	private:
+
+		MIDICLMessageWriter &
+		operator = (const MIDICLMessageWriter &inCopy);
+
+	// private data
+	private:
+
+		MIDICLPacketListBuilder &
+		mBuilder;
+
+		// NULL until something is written
+		Byte *
+		mPacket;
+
+		UInt32
+		mLength;
+
+		// the packet in progress goes out at this
+		MIDITimeStamp
+		mTimeStamp;
+
+		// the running status in this packet, 0 for none
+		Byte
+		mStatus;
+};
+
+#endif	// MIDICLMessageWriter_h
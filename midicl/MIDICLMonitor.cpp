@@ -6,23 +6,237 @@
 
 #include <CoreMIDI/CoreMIDI.h>
 
+#include <string.h>
+
+#include <chrono>
+
+// STATIC CONSTANTS
+
+// the time stamp and length in front of each packet in the ring
+static const UInt32	kRecordHeaderSize = sizeof (MIDITimeStamp) + sizeof (UInt16);
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLMonitor::MIDICLMonitor (FILE *outText, UInt32 inRingSize)
+	:
+	mText (outText),
+	mMask (0),
+	mReserve (0),
+	mWrite (0),
+	mRead (0),
+	mDropped (0),
+	mPacket (65536),
+	mStopping (false)
+{
+	UInt32	size = 1024;
+
+	while (size < inRingSize && size < 0x80000000)
+	{
+		size <<= 1;
+	}
+
+	mRing.resize (size);
+	mMask = size - 1;
+
+	mWriter = std::thread (&MIDICLMonitor::Write, this);
+}
+
+MIDICLMonitor::~MIDICLMonitor ()
+{
+	mStopping = true;
+	mWriter.join ();
+}
+
 // MIDICLINPUTPORTLISTENER IMPLEMENTATION
 
 void
 MIDICLMonitor::Hear (const MIDIPacketList *inPacketList)
 {
-	const MIDIPacket	*inputPacket (inPacketList->packet);
+	UInt32	size = mMask + 1;
 
-	for (UInt32	p = 0; p < inPacketList->numPackets;
-		p++, inputPacket = MIDIPacketNext (inputPacket))
+	const MIDIPacket	*packet (inPacketList->packet);
+
+	for (UInt32 p = 0; p < inPacketList->numPackets;
+		p++, packet = MIDIPacketNext (packet))
 	{
-		// copy & maybe channelise
-		for (UInt16 i = 0; i < inputPacket->length; i++)
+		UInt32	recordSize = kRecordHeaderSize + packet->length;
+		UInt32	reserve = mReserve.load (std::memory_order_relaxed);
+		bool		room;
+
+		// room for the record, against any other port's Hear() doing the same
+		do
+		{
+			room = size - (reserve - mRead.load (std::memory_order_acquire)) >= recordSize;
+		}
+		while (room && !mReserve.compare_exchange_weak (reserve, reserve + recordSize, std::memory_order_relaxed));
+
+		if (!room)
 		{
-			printf ("%02x ", inputPacket->data [i]);
+			mDropped.fetch_add (1, std::memory_order_relaxed);
+			continue;
 		}
 
-		printf ("\n");
+		UInt32	write = reserve;
+
+		Byte	header [kRecordHeaderSize];
+
+		memcpy (header, &packet->timeStamp, sizeof (MIDITimeStamp));
+		memcpy (header + sizeof (MIDITimeStamp), &packet->length, sizeof (UInt16));
+
+		// each piece in at most two copies, either side of the end of the ring
+		const Byte	*pieces [2] = { header, packet->data };
+		UInt32			lengths [2] = { kRecordHeaderSize, packet->length };
+
+		for (int piece = 0; piece < 2; piece++)
+		{
+			UInt32	offset = write & mMask;
+			UInt32	first = lengths [piece] < size - offset ? lengths [piece] : size - offset;
+
+			memcpy (&mRing [offset], pieces [piece], first);
+			memcpy (&mRing [0], pieces [piece] + first, lengths [piece] - first);
+
+			write += lengths [piece];
+		}
+
+		// records go to the writer in the order they were reserved
+		// so this waits for any reserved before it to be copied in
+		while (mWrite.load (std::memory_order_acquire) != reserve)
+		{
+			std::this_thread::yield ();
+		}
+
+		mWrite.store (write, std::memory_order_release);
+	}
+}
+
+// MIDICLPARSER HANDLER IMPLEMENTATION
+
+void
+MIDICLMonitor::Message (const MIDICLMessage &inMessage)
+{
+	fprintf (mText, "%02x", inMessage.mStatus);
+
+	for (Byte i = 0; i < inMessage.mDataLength; i++)
+	{
+		fprintf (mText, " %02x", inMessage.mData [i]);
 	}
+
+	fprintf (mText, "\n");
 }
 
+void
+MIDICLMonitor::SysEx (const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp)
+{
+	for (UInt32 i = 0; i < inLength; i++)
+	{
+		fprintf (mText, "%02x ", inData [i]);
+	}
+
+	fprintf (mText, "\n");
+}
+
+// PUBLIC METHODS
+
+bool
+MIDICLMonitor::Capture (const char *inPath, UInt32 inSegmentSize, UInt32 inSegmentCount)
+{
+	std::lock_guard<std::mutex>	lock (mCaptureMutex);
+
+	return mCapture.Open (inPath, inSegmentSize, inSegmentCount);
+}
+
+void
+MIDICLMonitor::StopCapture ()
+{
+	std::lock_guard<std::mutex>	lock (mCaptureMutex);
+
+	mCapture.Close ();
+}
+
+void
+MIDICLMonitor::Sync ()
+{
+	UInt32	write = mWrite.load (std::memory_order_acquire);
+
+	// mRead only ever goes up to mWrite, so this is done once it's been past write
+	while ((SInt32) (mRead.load (std::memory_order_acquire) - write) < 0)
+	{
+		std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	}
+}
+
+// PRIVATE METHODS
+
+void
+MIDICLMonitor::Write ()
+{
+	while (!mStopping)
+	{
+		if (!Drain ())
+		{
+			std::this_thread::sleep_for (std::chrono::milliseconds (kWriterInterval));
+		}
+	}
+
+	// the last of it
+	while (Drain ())
+	{
+	}
+}
+
+bool
+MIDICLMonitor::Drain ()
+{
+	UInt32	read = mRead.load (std::memory_order_relaxed);
+	UInt32	write = mWrite.load (std::memory_order_acquire);
+
+	if (read == write)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex>	lock (mCaptureMutex);
+
+	while (read != write)
+	{
+		MIDITimeStamp	timeStamp;
+		UInt16				length;
+
+		Read (read, &timeStamp, sizeof (timeStamp));
+		Read (read + sizeof (timeStamp), &length, sizeof (length));
+		Read (read + kRecordHeaderSize, &mPacket [0], length);
+
+		read += kRecordHeaderSize + length;
+
+		// one too big for a segment is dropped like one that didn't fit in the ring
+		if (mCapture.IsOpen () && !mCapture.Write (timeStamp, &mPacket [0], length))
+		{
+			mDropped.fetch_add (1, std::memory_order_relaxed);
+		}
+
+		if (mText != NULL)
+		{
+			mParser.Parse (&mPacket [0], length, timeStamp, *this);
+		}
+
+		// each packet's room goes back as soon as it's been read
+		mRead.store (read, std::memory_order_release);
+	}
+
+	if (mText != NULL)
+	{
+		fflush (mText);
+	}
+
+	return true;
+}
+
+void
+MIDICLMonitor::Read (UInt32 inIndex, void *outData, UInt32 inLength) const
+{
+	UInt32	offset = inIndex & mMask;
+	UInt32	first = inLength < mRing.size () - offset ? inLength : mRing.size () - offset;
+
+	memcpy (outData, &mRing [offset], first);
+	memcpy ((Byte *) outData + first, &mRing [0], inLength - first);
+}
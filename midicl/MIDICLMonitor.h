@@ -7,7 +7,18 @@
 
 // INCLUDES
 
+#include "MIDICLCaptureFile.h"
 #include "MIDICLInputPortListener.h"
+#include "MIDICLParser.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+#include <stdio.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // FORWARD DECLARATIONS
 
@@ -16,16 +27,146 @@ struct MIDIPacketList;
 
 // CLASS
 
+// logs what it hears, however the packets split it up
+// Hear() only copies each packet and its time stamp into a ring, it never prints or allocates
+// one monitor can hear several ports at once, each Hear() reserves its room in the ring
+// and only waits for another that reserved before it to finish copying in
+// a thread of its own takes them out every few milliseconds and writes them
+// to a MIDICLCaptureFile, and as a line per message to a text file if there is one
+// packets that arrive with the ring full, or too big for a capture segment, are dropped and counted
+
 class MIDICLMonitor
 	:
 	public MIDICLInputPortListener
 {
+	// static public constants
+	public:
+
+		// about four seconds of a USB cable flat out
+		static const UInt32	kDefaultRingSize = 1 << 20;
+
+		// how often the writer looks in the ring, in milliseconds
+		static const UInt32	kWriterInterval = 5;
+
+	// public constructors/destructor
+	public:
+
+		// outText can be NULL for no text
+		// inRingSize is rounded up to a power of two
+		MIDICLMonitor (FILE *outText = stdout, UInt32 inRingSize = kDefaultRingSize);
+
+		// writes whatever's left in the ring
+		~MIDICLMonitor ();
+
 	// MIDICLInputPortListener implementation
 	public:
 
 		void
 		Hear (const MIDIPacketList *inList);
+
+	// MIDICLParser handler implementation
+	public:
+
+		void
+		Message (const MIDICLMessage &inMessage);
+
+		void
+		SysEx (const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp);
+
+	// public methods
+	public:
+
+		// from any thread, starting with the next packet the writer takes out
+		// see MIDICLCaptureFile
+		bool
+		Capture (const char *inPath, UInt32 inSegmentSize, UInt32 inSegmentCount);
+
+		void
+		StopCapture ();
+
+		// packets, from any thread
+		UInt32
+		GetDroppedCount () const
+		{
+			return mDropped.load (std::memory_order_relaxed);
+		}
+
+		// waits for the writer to catch up with what's been heard so far
+		void
+		Sync ();
+
+	// private methods
+	private:
+
+		void
+		Write ();
+
+		// what's in the ring, returns false once there's nothing
+		bool
+		Drain ();
+
+		// inLength bytes from the ring at inIndex, which wraps
+		void
+		Read (UInt32 inIndex, void *outData, UInt32 inLength) const;
+
+	// private constructors
+	private:
+
+		MIDICLMonitor (const MIDICLMonitor &inCopy);
+
+	// private operators overloaded
+	private:
+
+		MIDICLMonitor &
+		operator = (const MIDICLMonitor &inCopy);
+
+	// private data
+	private:
+
+		FILE *
+		mText;
+
+		// a time stamp, a length and the data, one packet after another
+		std::vector<Byte>
+		mRing;
+
+		UInt32
+		mMask;
+
+		// free running, apart so Hear() and the writer don't share a line
+		// Hear() reserves up to mReserve, and what's copied in goes up to mWrite
+		alignas (64) std::atomic<UInt32>
+		mReserve;
+
+		std::atomic<UInt32>
+		mWrite;
+
+		alignas (64) std::atomic<UInt32>
+		mRead;
+
+		std::atomic<UInt32>
+		mDropped;
+
+		// the rest belong to the writer, apart from mCapture under mCaptureMutex
+
+		std::mutex
+		mCaptureMutex;
+
+		MIDICLCaptureFile
+		mCapture;
+
+		MIDICLParser
+		mParser;
+
+		// one packet at a time, out of the ring
+		std::vector<Byte>
+		mPacket;
+
+		std::atomic<bool>
+		mStopping;
+
+		std::thread
+		mWriter;
 };
 
 #endif	// MIDICLMonitor_h
-
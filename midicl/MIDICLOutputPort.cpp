@@ -6,6 +6,7 @@
 
 #include "MIDICLClient.h"
 #include "MIDICLException.h"
+#include "MIDICLPacketListBuilder.h"
 
 // PUBLIC CONSTRUCTORS/DESTRUCTOR
 
@@ -31,69 +32,99 @@ MIDICLOutputPort::~MIDICLOutputPort ()
 // PUBLIC CONVENIENCE METHODS
 
 void
-MIDICLOutputPort::SendChannelAftertouch (Byte inChannel, Byte inPressure)
+MIDICLOutputPort::SendChannelAftertouch (Byte inChannel, Byte inPressure, MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDIChannelAftertouchMessage | inChannel, inPressure);
+	Byte	buffer [] = { (Byte) (MIDICLClient::kMIDIChannelAftertouchMessage | inChannel), inPressure };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendPolyAftertouch (Byte inChannel, Byte inKey, Byte inPressure)
+MIDICLOutputPort::SendPolyAftertouch (Byte inChannel, Byte inKey, Byte inPressure, MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDIPolyAftertouchMessage | inChannel, inKey, inPressure);
+	Byte	buffer [] = { (Byte) (MIDICLClient::kMIDIPolyAftertouchMessage | inChannel), inKey, inPressure };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
+}
+
+void
+MIDICLOutputPort::SendControlChange (Byte inChannel, Byte inControl, Byte inValue, MIDITimeStamp inTimeStamp)
+{
+	Byte	buffer [] = { (Byte) (MIDICLClient::kMIDIControlChangeMessage | inChannel), inControl, inValue };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendControlChange (Byte inChannel, Byte inControl, Byte inValue)
+MIDICLOutputPort::SendNoteOff (Byte inChannel, Byte inKey, Byte inVelocity, MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDIControlChangeMessage | inChannel, inControl, inValue);
+	Byte	buffer [] = { (Byte) (MIDICLClient::kMIDINoteOffMessage | inChannel), inKey, inVelocity };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendNoteOff (Byte inChannel, Byte inKey, Byte inVelocity)
+MIDICLOutputPort::SendNoteOn (Byte inChannel, Byte inKey, Byte inVelocity, MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDINoteOffMessage | inChannel, inKey, inVelocity);
+	Byte	buffer [] = { (Byte) (MIDICLClient::kMIDINoteOnMessage | inChannel), inKey, inVelocity };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendNoteOn (Byte inChannel, Byte inKey, Byte inVelocity)
+MIDICLOutputPort::SendPitchBend (Byte inChannel, Byte inLSB, Byte inMSB, MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDINoteOnMessage | inChannel, inKey, inVelocity);
+	Byte	buffer [] = { (Byte) (MIDICLClient::kMIDIPitchBendMessage | inChannel), inLSB, inMSB };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendPitchBend (Byte inChannel, Byte inLSB, Byte inMSB)
+MIDICLOutputPort::SendProgramChange (Byte inChannel, Byte inProgram, MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDIPitchBendMessage | inChannel, inLSB, inMSB);
+	Byte	buffer [] = { (Byte) (MIDICLClient::kMIDIProgramChangeMessage | inChannel), inProgram };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendProgramChange (Byte inChannel, Byte inProgram)
+MIDICLOutputPort::SendClock (MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDIProgramChangeMessage | inChannel, inProgram);
+	Byte	buffer [] = { (Byte) MIDICLClient::kMIDIClockMessage };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendClock ()
+MIDICLOutputPort::SendStart (MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDIClockMessage);
+	Byte	buffer [] = { (Byte) MIDICLClient::kMIDIStartMessage };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendStart ()
+MIDICLOutputPort::SendContinue (MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDIStartMessage);
+	Byte	buffer [] = { (Byte) MIDICLClient::kMIDIContinueMessage };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendContinue ()
+MIDICLOutputPort::SendStop (MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDIContinueMessage);
+	Byte	buffer [] = { (Byte) MIDICLClient::kMIDIStopMessage };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 void
-MIDICLOutputPort::SendStop ()
+MIDICLOutputPort::SendSongPosition (unsigned int inPosition, MIDITimeStamp inTimeStamp)
 {
-	SendSmallPacket (MIDICLClient::kMIDIStopMessage);
+	Byte	buffer [] = { (Byte) MIDICLClient::kMIDISongPositionMessage, (Byte) (inPosition & 0x7f), (Byte) ((inPosition >> 7) & 0x7f) };
+
+	SendBytes (buffer, sizeof (buffer), inTimeStamp);
 }
 
 // PUBLIC METHODS
@@ -112,90 +143,36 @@ MIDICLOutputPort::SendPacketList (const MIDIPacketList *inPacketList)
 void
 MIDICLOutputPort::SendSmallPacket (Byte inOne)
 {
-	Byte	packetListBuffer [32];
-
-	MIDIPacketList	*packetList ((MIDIPacketList *) packetListBuffer);
-	MIDIPacket	*packet (MIDIPacketListInit (packetList));
-
 	Byte	buffer [1];
 
 	buffer [0] = inOne;
 
-	packet = MIDIPacketListAdd (packetList, sizeof (packetListBuffer),
-		packet, 0, 1, buffer);
-
-	if (packet == NULL)
-	{
-		throw MIDICLException (MIDICLException::kMIDIPacketListAdd, 0);
-	}
-
-	OSStatus	errCode = MIDISend (mPortRef, mDestination, packetList);
-
-	if (errCode != 0)
-	{
-		throw MIDICLException (MIDICLException::kMIDISend, errCode);
-	}
+	SendBytes (buffer, 1, 0);
 }
 
 void
 MIDICLOutputPort::SendSmallPacket
 	(Byte inOne, Byte inTwo)
 {
-	Byte	packetListBuffer [32];
-
-	MIDIPacketList	*packetList ((MIDIPacketList *) packetListBuffer);
-	MIDIPacket	*packet (MIDIPacketListInit (packetList));
-
 	Byte	buffer [2];
 
 	buffer [0] = inOne;
 	buffer [1] = inTwo;
 
-	packet = MIDIPacketListAdd (packetList, sizeof (packetListBuffer),
-		packet, 0, 2, buffer);
-
-	if (packet == NULL)
-	{
-		throw MIDICLException (MIDICLException::kMIDIPacketListAdd, 0);
-	}
-
-	OSStatus	errCode = MIDISend (mPortRef, mDestination, packetList);
-
-	if (errCode != 0)
-	{
-		throw MIDICLException (MIDICLException::kMIDISend, errCode);
-	}
+	SendBytes (buffer, 2, 0);
 }
 
 void
 MIDICLOutputPort::SendSmallPacket
 	(Byte inOne, Byte inTwo, Byte inThree)
 {
-	Byte	packetListBuffer [32];
-
-	MIDIPacketList	*packetList ((MIDIPacketList *) packetListBuffer);
-	MIDIPacket	*packet (MIDIPacketListInit (packetList));
-
 	Byte	buffer [3];
 
 	buffer [0] = inOne;
 	buffer [1] = inTwo;
 	buffer [2] = inThree;
 
-	packet = MIDIPacketListAdd (packetList, sizeof (packetListBuffer),
-		packet, 0, 3, buffer);
-
-	if (packet == NULL)
-	{
-		throw MIDICLException (MIDICLException::kMIDIPacketListAdd, 0);
-	}
-
-	OSStatus	errCode = MIDISend (mPortRef, mDestination, packetList);
-
-	if (errCode != 0)
-	{
-		throw MIDICLException (MIDICLException::kMIDISend, errCode);
-	}
+	SendBytes (buffer, 3, 0);
 }
 
 void
@@ -231,6 +208,19 @@ MIDICLOutputPort::SetDestination (MIDIEndpointRef inDestination)
 
 // PRIVATE METHODS
 
+void
+MIDICLOutputPort::SendBytes (const Byte *inBuffer, UInt32 inLength, MIDITimeStamp inTimeStamp)
+{
+	// on the stack so any thread can send
+	// UInt32 for the alignment the packet list needs
+	UInt32	storage [16];
+
+	MIDICLPacketListBuilder	builder (this, (Byte *) storage, sizeof (storage));
+
+	builder.Add (inTimeStamp, inBuffer, inLength);
+	builder.Flush ();
+}
+
 void
 MIDICLOutputPort::SendSysExCompleted ()
 {
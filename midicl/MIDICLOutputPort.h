@@ -22,40 +22,46 @@ class MIDICLOutputPort
 		~MIDICLOutputPort ();
 
 	// public convenience methods
+	// each goes out at the host time given
+	// zero, the default, means straight away
 	public:
 
 		void
-		SendChannelAftertouch (Byte inChannel, Byte inPressure);
+		SendChannelAftertouch (Byte inChannel, Byte inPressure, MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendPolyAftertouch (Byte inChannel, Byte inKey, Byte inPressure);
+		SendPolyAftertouch (Byte inChannel, Byte inKey, Byte inPressure, MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendControlChange (Byte inChannel, Byte inControl, Byte inValue);
+		SendControlChange (Byte inChannel, Byte inControl, Byte inValue, MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendNoteOff (Byte inChannel, Byte inKey, Byte inVelocity);
+		SendNoteOff (Byte inChannel, Byte inKey, Byte inVelocity, MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendNoteOn (Byte inChannel, Byte inKey, Byte inVelocity);
+		SendNoteOn (Byte inChannel, Byte inKey, Byte inVelocity, MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendPitchBend (Byte inChannel, Byte inLSB, Byte inMSB);
+		SendPitchBend (Byte inChannel, Byte inLSB, Byte inMSB, MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendProgramChange (Byte inChannel, Byte inProgram);
+		SendProgramChange (Byte inChannel, Byte inProgram, MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendClock ();
+		SendClock (MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendStart ();
+		SendStart (MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendContinue ();
+		SendContinue (MIDITimeStamp inTimeStamp = 0);
 
 		void
-		SendStop ();
+		SendStop (MIDITimeStamp inTimeStamp = 0);
+
+		// in sixteenths from the start of the song
+		void
+		SendSongPosition (unsigned int inPosition, MIDITimeStamp inTimeStamp = 0);
 
 	// public byte-level methods
 	public:
@@ -89,6 +95,13 @@ class MIDICLOutputPort
 		SetDestination (MIDIEndpointRef inDestination);
 			// throws MIDICLException
 
+	// private methods
+	private:
+
+		void
+		SendBytes (const Byte *inBuffer, UInt32 inLength, MIDITimeStamp inTimeStamp);
+			// throws MIDICLException
+
 	// static private methods
 	private:
 
@@ -0,0 +1,215 @@
+// MIDICLPacketListBuilder.cpp
+
+// INCLUDES
+
+#include "MIDICLPacketListBuilder.h"
+
+#include "MIDICLException.h"
+#include "MIDICLOutputPort.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include <mutex>
+
+// STATIC DATA
+
+// blocks are powers of two from 1k, up to one that fits the longest packet there is
+static const UInt32	kSmallestBlockBits = 10;
+static const UInt32	kBlockSizeCount = 8;
+
+// freed blocks keep the next one's address at the front
+static Byte		*sFreeBlocks [kBlockSizeCount];
+static std::mutex	sPoolMutex;
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLPacketListBuilder::MIDICLPacketListBuilder (MIDICLOutputPort *outPort)
+	:
+	mOutputPort (outPort),
+	mPooled (true)
+{
+	mStorage = Allocate (kDefaultSize, &mSize);
+
+	Reset ();
+}
+
+MIDICLPacketListBuilder::MIDICLPacketListBuilder
+	(MIDICLOutputPort *outPort, Byte *inStorage, UInt32 inSize)
+	:
+	mOutputPort (outPort),
+	mStorage (inStorage),
+	mSize (inSize),
+	mPooled (false)
+{
+	Reset ();
+}
+
+MIDICLPacketListBuilder::~MIDICLPacketListBuilder ()
+{
+	if (mPooled)
+	{
+		Release (mStorage, mSize);
+	}
+}
+
+// PUBLIC METHODS
+
+void
+MIDICLPacketListBuilder::Add (MIDITimeStamp inTimeStamp, const Byte *inData, UInt32 inLength)
+{
+	Byte	*data = Reserve (inLength);
+
+	memcpy (data, inData, inLength);
+
+	Commit (inTimeStamp, inLength);
+}
+
+Byte *
+MIDICLPacketListBuilder::Reserve (UInt32 inLength)
+{
+	// a packet's length is 16 bits
+	if (inLength > 0xffff)
+	{
+		throw MIDICLException (MIDICLException::kMIDIPacketListAdd, 0);
+	}
+
+	if (!HasRoom (inLength))
+	{
+		Flush ();
+
+		if (!HasRoom (inLength))
+		{
+			Grow (inLength);
+		}
+	}
+
+	return mPacket->data;
+}
+
+void
+MIDICLPacketListBuilder::Commit (MIDITimeStamp inTimeStamp, UInt32 inLength)
+{
+	mPacket->timeStamp = inTimeStamp;
+	mPacket->length = inLength;
+
+	mPacketList->numPackets++;
+
+	mPacket = MIDIPacketNext (mPacket);
+}
+
+void
+MIDICLPacketListBuilder::Flush ()
+{
+	if (mPacketList->numPackets == 0)
+	{
+		return;
+	}
+
+	try
+	{
+		mOutputPort->SendPacketList (mPacketList);
+	}
+	catch (...)
+	{
+		// it won't go any better next time
+		Reset ();
+		throw;
+	}
+
+	Reset ();
+}
+
+// PRIVATE METHODS
+
+void
+MIDICLPacketListBuilder::Reset ()
+{
+	mPacketList = (MIDIPacketList *) mStorage;
+	mPacket = MIDIPacketListInit (mPacketList);
+}
+
+bool
+MIDICLPacketListBuilder::HasRoom (UInt32 inLength) const
+{
+	return (Byte *) mPacket + offsetof (MIDIPacket, data) + inLength <= mStorage + mSize;
+}
+
+void
+MIDICLPacketListBuilder::Grow (UInt32 inLength)
+{
+	UInt32	size = 0;
+	Byte	*storage = Allocate
+		(offsetof (MIDIPacketList, packet) + offsetof (MIDIPacket, data) + inLength, &size);
+
+	// the caller's storage is still theirs
+	if (mPooled)
+	{
+		Release (mStorage, mSize);
+	}
+
+	mStorage = storage;
+	mSize = size;
+	mPooled = true;
+
+	Reset ();
+}
+
+// STATIC PRIVATE METHODS
+
+Byte *
+MIDICLPacketListBuilder::Allocate (UInt32 inSize, UInt32 *outSize)
+{
+	UInt32	bits = kSmallestBlockBits;
+
+	while ((1U << bits) < inSize)
+	{
+		bits++;
+	}
+
+	*outSize = 1U << bits;
+
+	// growing can happen in a read proc, so rather than wait on the pool it goes without
+	std::unique_lock<std::mutex>	lock (sPoolMutex, std::try_to_lock);
+
+	if (bits - kSmallestBlockBits < kBlockSizeCount && lock.owns_lock ())
+	{
+		Byte	*&freeBlocks = sFreeBlocks [bits - kSmallestBlockBits];
+
+		if (freeBlocks)
+		{
+			Byte	*block = freeBlocks;
+
+			memcpy (&freeBlocks, block, sizeof (Byte *));
+
+			return block;
+		}
+	}
+
+	return new Byte [*outSize];
+}
+
+void
+MIDICLPacketListBuilder::Release (Byte *inBlock, UInt32 inSize)
+{
+	UInt32	bits = kSmallestBlockBits;
+
+	while ((1U << bits) < inSize)
+	{
+		bits++;
+	}
+
+	std::unique_lock<std::mutex>	lock (sPoolMutex, std::try_to_lock);
+
+	if (bits - kSmallestBlockBits < kBlockSizeCount && lock.owns_lock ())
+	{
+		Byte	*&freeBlocks = sFreeBlocks [bits - kSmallestBlockBits];
+
+		memcpy (inBlock, &freeBlocks, sizeof (Byte *));
+		freeBlocks = inBlock;
+	}
+	else
+	{
+		delete [] inBlock;
+	}
+}
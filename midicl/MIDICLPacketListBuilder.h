@@ -0,0 +1,138 @@
+// MIDICLPacketListBuilder.h
+
+// GUARD
+
+#ifndef MIDICLPacketListBuilder_h
+#define MIDICLPacketListBuilder_h
+
+// INCLUDES
+
+#include <CoreMIDI/MIDIServices.h>
+
+// FORWARD DECLARATIONS
+
+class MIDICLOutputPort;
+
+// CLASS
+
+// builds packet lists for an output port, sending them when they fill
+// starts in storage the caller gives it or in a block from a shared pool
+// and moves to a bigger pooled block for a packet that won't fit
+// the pool is never waited on, a block comes from new and goes back to delete while it's busy
+// keeps its storage from one list to the next, so it can live as long as its owner
+// one thread at a time
+
+class MIDICLPacketListBuilder
+{
+	// static public constants
+	public:
+
+		static const UInt32	kDefaultSize = 1024;
+
+	// public constructors/destructor
+	public:
+
+		// starts in a pooled block of kDefaultSize
+		MIDICLPacketListBuilder (MIDICLOutputPort *outPort);
+
+		// starts in inStorage, which must be 4 byte aligned and outlive the builder
+		MIDICLPacketListBuilder (MIDICLOutputPort *outPort, Byte *inStorage, UInt32 inSize);
+
+		~MIDICLPacketListBuilder ();
+
+	// public methods
+	public:
+
+		// copies a packet in
+		void
+		Add (MIDITimeStamp inTimeStamp, const Byte *inData, UInt32 inLength);
+			// throws MIDICLException
+
+		// room for a packet of up to inLength bytes to be written straight into
+		// sending what's there first if there isn't room after it
+		Byte *
+		Reserve (UInt32 inLength);
+			// throws MIDICLException
+
+		// adds the packet written into the last Reserve()
+		// inLength can be anything up to what was reserved
+		void
+		Commit (MIDITimeStamp inTimeStamp, UInt32 inLength);
+
+		// sends what's there, if anything, and starts again
+		void
+		Flush ();
+			// throws MIDICLException
+
+		// drops what's there without sending it
+		void
+		Clear ()
+		{
+			Reset ();
+		}
+
+		const MIDIPacketList *
+		GetPacketList () const
+		{
+			return mPacketList;
+		}
+
+	// private methods
+	private:
+
+		void
+		Reset ();
+
+		bool
+		HasRoom (UInt32 inLength) const;
+
+		// empty, into storage with room for inLength on its own
+		void
+		Grow (UInt32 inLength);
+
+	// static private methods
+	private:
+
+		// at least inSize, with how much it really is in outSize
+		static Byte *
+		Allocate (UInt32 inSize, UInt32 *outSize);
+
+		static void
+		Release (Byte *inBlock, UInt32 inSize);
+
+	// private constructors
+	private:
+
+		MIDICLPacketListBuilder (const MIDICLPacketListBuilder &inCopy);
+
+	// private operators overloaded
+	private:
+
+		MIDICLPacketListBuilder &
+		operator = (const MIDICLPacketListBuilder &inCopy);
+
+	// private data
+	private:
+
+		MIDICLOutputPort *
+		mOutputPort;
+
+		Byte *
+		mStorage;
+
+		UInt32
+		mSize;
+
+		// whether mStorage came from the pool and goes back to it
+		bool
+		mPooled;
+
+		MIDIPacketList *
+		mPacketList;
+
+		// where the next packet goes
+		MIDIPacket *
+		mPacket;
+};
+
+#endif	// MIDICLPacketListBuilder_h
@@ -0,0 +1,58 @@
+// MIDICLParser.cpp
+
+// INCLUDES
+
+#include "MIDICLParser.h"
+
+// STATIC DATA
+
+// a row for each high nibble
+// data, channel messages with one or two data bytes, system common with none to two,
+// sysex start and end, real time
+
+static const Byte	kD = MIDICLParser::kData;
+static const Byte	kC1 = MIDICLParser::kChannel | 1;
+static const Byte	kC2 = MIDICLParser::kChannel | 2;
+static const Byte	kS0 = MIDICLParser::kCommon;
+static const Byte	kS1 = MIDICLParser::kCommon | 1;
+static const Byte	kS2 = MIDICLParser::kCommon | 2;
+static const Byte	kX = MIDICLParser::kSysExStart;
+static const Byte	kE = MIDICLParser::kCommon | MIDICLParser::kSysExEnd;
+static const Byte	kR = MIDICLParser::kRealTime;
+
+const Byte	MIDICLParser::kByteClasses [256] =
+{
+	// 00
+	kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD,
+	// 10
+	kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD,
+	// 20
+	kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD,
+	// 30
+	kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD,
+	// 40
+	kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD,
+	// 50
+	kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD,
+	// 60
+	kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD,
+	// 70
+	kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD, kD,
+	// 80
+	kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2,
+	// 90
+	kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2,
+	// a0
+	kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2,
+	// b0
+	kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2,
+	// c0
+	kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1,
+	// d0
+	kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1, kC1,
+	// e0
+	kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2, kC2,
+	// f0
+	kX, kS1, kS2, kS1, kS0, kS0, kS0, kE, kR, kR, kR, kR, kR, kR, kR, kR
+};
+
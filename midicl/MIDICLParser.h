@@ -0,0 +1,231 @@
+// MIDICLParser.h
+
+// GUARD
+
+#ifndef MIDICLParser_h
+#define MIDICLParser_h
+
+// INCLUDES
+
+#include "MIDICLMessage.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// turns a stream of packets into complete messages, whatever the packets' boundaries
+// keeps running status, the message in progress and sysex from one Parse() to the next
+// so one parser per source, kept as long as the source is
+// real time bytes come out as they arrive, even in the middle of another message
+// never allocates
+//
+// H provides
+//
+//		void
+//		Message (const MIDICLMessage &inMessage);
+//
+//		// a piece of a sysex, the first starts with 0xf0
+//		// the last ends with 0xf7, unless a status byte cut it short
+//		void
+//		SysEx (const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp);
+
+class MIDICLParser
+{
+	// static public constants
+	public:
+
+		// each byte's entry in kByteClasses
+		// statuses have their data length in the low bits
+		enum
+		{
+			kDataLengthMask = 0x03,
+			kData = 0x04,
+			kChannel = 0x08,
+			kCommon = 0x10,
+			kSysExStart = 0x20,
+			kSysExEnd = 0x40,
+			kRealTime = 0x80
+		};
+
+		static const Byte	kByteClasses [256];
+
+	// public constructors/destructor
+	public:
+
+		MIDICLParser ()
+			:
+			mStatus (0),
+			mDataLength (0),
+			mDataCount (0),
+			mSysEx (false)
+		{
+			mData [0] = mData [1] = 0;
+		}
+
+	// public methods
+	public:
+
+		template <class H> void
+		Parse (const MIDIPacketList *inList, H &ioHandler)
+		{
+			const MIDIPacket	*packet (inList->packet);
+
+			for (UInt32 p = 0; p < inList->numPackets;
+				p++, packet = MIDIPacketNext (packet))
+			{
+				Parse (packet->data, packet->length, packet->timeStamp, ioHandler);
+			}
+		}
+
+		template <class H> void
+		Parse (const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp, H &ioHandler);
+
+		// forgets anything part way through
+		void
+		Reset ()
+		{
+			mStatus = 0;
+			mDataCount = 0;
+			mSysEx = false;
+		}
+
+	// private data
+	private:
+
+		// running status, 0 for none
+		Byte
+		mStatus;
+
+		Byte
+		mDataLength;
+
+		Byte
+		mDataCount;
+
+		Byte
+		mData [2];
+
+		bool
+		mSysEx;
+};
+
+// PUBLIC METHODS
+
+template <class H> void
+MIDICLParser::Parse (const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp, H &ioHandler)
+{
+	// where the part of a sysex in this buffer started
+	UInt32	sysExStart = 0;
+
+	for (UInt32 i = 0; i < inLength; i++)
+	{
+		Byte	byte = inData [i];
+		Byte	byteClass = kByteClasses [byte];
+
+		if (mSysEx)
+		{
+			// sysex data goes out in one piece, not a byte at a time
+			while ((byteClass & kData) && ++i < inLength)
+			{
+				byte = inData [i];
+				byteClass = kByteClasses [byte];
+			}
+
+			if (i == inLength)
+			{
+				break;
+			}
+
+			if (byteClass & kRealTime)
+			{
+				if (i > sysExStart)
+				{
+					ioHandler.SysEx (inData + sysExStart, i - sysExStart, inTimeStamp);
+				}
+
+				sysExStart = i + 1;
+			}
+			else
+			{
+				// the end, or a status that cuts it short
+				UInt32	end = byteClass & kSysExEnd ? i + 1 : i;
+
+				if (end > sysExStart)
+				{
+					ioHandler.SysEx (inData + sysExStart, end - sysExStart, inTimeStamp);
+				}
+
+				mSysEx = false;
+
+				if (byteClass & kSysExEnd)
+				{
+					continue;
+				}
+			}
+		}
+
+		if (byteClass & kData)
+		{
+			// data with no status to go with it is dropped
+			if (mStatus == 0)
+			{
+				continue;
+			}
+
+			mData [mDataCount++] = byte;
+		}
+		else if (byteClass & kRealTime)
+		{
+			MIDICLMessage	message;
+
+			message.mTimeStamp = inTimeStamp;
+			message.mStatus = byte;
+			message.mDataLength = 0;
+
+			ioHandler.Message (message);
+			continue;
+		}
+		else if (byteClass & kSysExStart)
+		{
+			mStatus = 0;
+			mSysEx = true;
+			sysExStart = i;
+			continue;
+		}
+		else
+		{
+			// an 0xf7 on its own comes out as a message of its own
+			mStatus = byte;
+			mDataLength = byteClass & kDataLengthMask;
+			mDataCount = 0;
+		}
+
+		if (mDataCount == mDataLength)
+		{
+			MIDICLMessage	message;
+
+			message.mTimeStamp = inTimeStamp;
+			message.mStatus = mStatus;
+			message.mData [0] = mData [0];
+			message.mData [1] = mData [1];
+			message.mDataLength = mDataLength;
+
+			ioHandler.Message (message);
+
+			mDataCount = 0;
+
+			// running status is only for channel messages
+			if ((kByteClasses [mStatus] & kChannel) == 0)
+			{
+				mStatus = 0;
+			}
+		}
+	}
+
+	if (mSysEx && inLength > sysExStart)
+	{
+		ioHandler.SysEx (inData + sysExStart, inLength - sysExStart, inTimeStamp);
+	}
+}
+
+#endif	// MIDICLParser_h
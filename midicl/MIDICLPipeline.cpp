@@ -0,0 +1,356 @@
+// MIDICLPipeline.cpp
+
+// INCLUDES
+
+#include "MIDICLPipeline.h"
+
+#include "MIDICLClient.h"
+
+#include <string.h>
+
+#include <memory>
+#include <thread>
+
+// STATIC CONSTANTS
+
+// how far past its end a piece can go to finish a message, with real time in the way
+static const UInt32	kRunOn = 4;
+
+// the most of a packet that goes out in one, grown by half again and two it still fits
+// with room for a piece to run on to the end of the message it stops in
+static const UInt32	kLongestPiece = (0xffff - 2 - kRunOn * 3 / 2) * 2 / 3;
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLPipeline::MIDICLPipeline (MIDICLOutputPort *outPort)
+	:
+	mBuilder (outPort),
+	mChannels (0xffff),
+	mMessages (0xff),
+	mTranspose (0),
+	mTables (nullptr),
+	mEpoch (0),
+	mStatus (0),
+	mDropping (true),
+	mDataCount (0),
+	mKey (0)
+{
+	for (Byte channel = 0; channel < 16; channel++)
+	{
+		mChannelMap [channel] = channel;
+	}
+
+	memset (mSounding, 0xff, sizeof (mSounding));
+
+	mReaders [0] = 0;
+	mReaders [1] = 0;
+
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	Publish ();
+}
+
+MIDICLPipeline::~MIDICLPipeline ()
+{
+	delete mTables.load ();
+}
+
+// MIDICLINPUTPORTLISTENER IMPLEMENTATION
+
+void
+MIDICLPipeline::Hear (const MIDIPacketList *inList)
+{
+	Run (inList, mBuilder);
+
+	mBuilder.Flush ();
+}
+
+// PUBLIC METHODS
+
+void
+MIDICLPipeline::Run (const MIDIPacketList *inList, MIDICLPacketListBuilder &ioBuilder)
+{
+	UInt32	epoch = mEpoch.load ();
+
+	// counted in an epoch before Publish() moved on would go unwaited for, so look again
+	for (;;)
+	{
+		mReaders [epoch & 1]++;
+
+		UInt32	now = mEpoch.load ();
+
+		if (now == epoch)
+		{
+			break;
+		}
+
+		mReaders [epoch & 1]--;
+		epoch = now;
+	}
+
+	try
+	{
+		Run (mTables.load (), inList, ioBuilder);
+	}
+	catch (...)
+	{
+		mReaders [epoch & 1]--;
+		throw;
+	}
+
+	mReaders [epoch & 1]--;
+}
+
+void
+MIDICLPipeline::SetFilter (UInt16 inChannels, Byte inMessages)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	mChannels = inChannels;
+	mMessages = inMessages;
+
+	Publish ();
+}
+
+void
+MIDICLPipeline::SetChannelMap (Byte inFromChannel, Byte inToChannel)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	mChannelMap [inFromChannel & 0xf] = inToChannel & 0xf;
+
+	Publish ();
+}
+
+void
+MIDICLPipeline::SetTranspose (int inTranspose)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	mTranspose = inTranspose < -127 ? -127 : (inTranspose > 127 ? 127 : inTranspose);
+
+	Publish ();
+}
+
+void
+MIDICLPipeline::SetScale (UInt16 inScale, Byte inRoot)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	mQuantiser.SetScale (inScale, inRoot);
+
+	Publish ();
+}
+
+// PRIVATE METHODS
+
+void
+MIDICLPipeline::Run (const Tables *inTables, const MIDIPacketList *inList, MIDICLPacketListBuilder &ioBuilder)
+{
+	const MIDIPacket	*inputPacket (inList->packet);
+
+	for (UInt32 p = 0; p < inList->numPackets;
+		p++, inputPacket = MIDIPacketNext (inputPacket))
+	{
+		// a long packet goes out as several, as if it had come in pieces
+		// each ending with a whole message
+		for (UInt32 start = 0, end = 0; start < inputPacket->length; start = end)
+		{
+			end = inputPacket->length - start > kLongestPiece ? start + kLongestPiece : inputPacket->length;
+
+			// a note can go out longer than it came in, with its status spelled out
+			// or with the key it had in an earlier packet, but never by more than this
+			Byte	*output = ioBuilder.Reserve ((end - start + kRunOn) * 3 / 2 + 2);
+			UInt16	length = 0;
+
+			// each packet starts with a status of its own
+			Byte	outputStatus = 0;
+
+			UInt32	i = start;
+
+			// a piece runs on past its end to finish the message it's in
+			for (; i < end || (i < end + kRunOn && i < inputPacket->length && mDataCount != 0); i++)
+			{
+				Byte	byte = inputPacket->data [i];
+
+				if (byte >= 0x80)
+				{
+					Byte	status = inTables->mStatuses [byte & 0x7f];
+
+					// real time can turn up anywhere and changes nothing
+					if (byte < MIDICLClient::kMIDIClockMessage)
+					{
+						// system common and sysex cancel running status
+						mStatus = byte < MIDICLClient::kMIDIStartSysExMessage ? byte : 0;
+						mDropping = status == 0;
+						mDataCount = 0;
+					}
+
+					// a note's status goes with the rest of it, once it's known where that goes
+					if (status != 0
+						&& (byte < MIDICLClient::kMIDINoteOffMessage || byte >= MIDICLClient::kMIDIControlChangeMessage))
+					{
+						output [length++] = status;
+
+						if (byte < MIDICLClient::kMIDIClockMessage)
+						{
+							outputStatus = byte < MIDICLClient::kMIDIStartSysExMessage ? status : 0;
+						}
+					}
+
+					continue;
+				}
+
+				Byte	type = mStatus & 0xf0;
+
+				if (type == MIDICLClient::kMIDINoteOffMessage
+					|| type == MIDICLClient::kMIDINoteOnMessage
+					|| type == MIDICLClient::kMIDIPolyAftertouchMessage)
+				{
+					if (mDataCount == 0)
+					{
+						// whether it's on or off depends on the velocity still to come
+						// so the whole message waits for it, even into the next packet
+						mKey = byte;
+						mDataCount = 1;
+
+						continue;
+					}
+
+					mDataCount = 0;
+
+					Note	&note (mSounding [mStatus & 0xf][mKey]);
+					Byte	status = inTables->mStatuses [mStatus & 0x7f];
+					Byte	key = inTables->mKeys [mKey];
+					bool	on = type == MIDICLClient::kMIDINoteOnMessage && byte > 0;
+					bool	off = !on && type != MIDICLClient::kMIDIPolyAftertouchMessage;
+					bool	sounding = note.mKey != 0xff;
+
+					// a note off gets past the filter to a note that's sounding
+					if (status == 0 && !(off && sounding))
+					{
+						continue;
+					}
+
+					if (on)
+					{
+						note.mChannel = status & 0xf;
+						note.mKey = key;
+					}
+					else if (sounding)
+					{
+						// goes where its note on did, even if the stages changed between
+						status = type | note.mChannel;
+						key = note.mKey;
+
+						if (off)
+						{
+							note.mKey = 0xff;
+						}
+					}
+
+					if (status != outputStatus)
+					{
+						output [length++] = status;
+						outputStatus = status;
+					}
+
+					output [length++] = key;
+					output [length++] = byte;
+
+					continue;
+				}
+
+				// in running status each message goes by the stages as they are when it starts
+				if (mStatus != 0 && mDataCount == 0)
+				{
+					Byte	status = inTables->mStatuses [mStatus & 0x7f];
+
+					mDropping = status == 0;
+
+					// running status doesn't carry from packet to packet, so it's spelled out again
+					if (!mDropping && status != outputStatus)
+					{
+						output [length++] = status;
+						outputStatus = status;
+					}
+				}
+
+				if (!mDropping)
+				{
+					output [length++] = byte;
+				}
+
+				// program change and channel pressure have one data byte, the rest two
+				if (mStatus != 0)
+				{
+					bool	single = type == MIDICLClient::kMIDIProgramChangeMessage
+						|| type == MIDICLClient::kMIDIChannelAftertouchMessage;
+
+					mDataCount = single || mDataCount == 1 ? 0 : 1;
+				}
+			}
+
+			end = i;
+
+			if (length > 0)
+			{
+				ioBuilder.Commit (0, length);
+			}
+		}
+	}
+}
+
+void
+MIDICLPipeline::Publish ()
+{
+	std::unique_ptr<Tables>	tables (new Tables);
+
+	for (int status = 0x80; status <= 0xff; status++)
+	{
+		bool	passes;
+		Byte	mapped = status;
+
+		if (status < MIDICLClient::kMIDIStartSysExMessage)
+		{
+			passes = (mMessages & (1 << ((status >> 4) - 8))) && (mChannels & (1 << (status & 0xf)));
+			mapped = (status & 0xf0) | mChannelMap [status & 0xf];
+		}
+		else
+		{
+			passes = (mMessages & 0x80) != 0;
+		}
+
+		tables->mStatuses [status & 0x7f] = passes ? mapped : 0;
+	}
+
+	for (int note = 0; note < 128; note++)
+	{
+		int	transposed = note + mTranspose;
+
+		while (transposed > 127)
+		{
+			transposed -= 12;
+		}
+
+		while (transposed < 0)
+		{
+			transposed += 12;
+		}
+
+		tables->mKeys [note] = mQuantiser.Quantise (transposed);
+	}
+
+	const Tables	*old = mTables.exchange (tables.release ());
+
+	// a Run() that starts from here on counts in the new epoch and sees the new tables
+	// so once the old epoch's count is down to nothing, nothing has the old ones
+	UInt32	epoch = mEpoch++;
+
+	while (mReaders [epoch & 1] != 0)
+	{
+		std::this_thread::yield ();
+	}
+
+	delete old;
+}
@@ -0,0 +1,186 @@
+// MIDICLPipeline.h
+
+// GUARD
+
+#ifndef MIDICLPipeline_h
+#define MIDICLPipeline_h
+
+// INCLUDES
+
+#include "MIDICLInputPortListener.h"
+#include "MIDICLPacketListBuilder.h"
+#include "MIDICLScaleQuantiser.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+#include <atomic>
+#include <mutex>
+
+// FORWARD DECLARATIONS
+
+class MIDICLOutputPort;
+
+// CLASS
+
+// filters, remaps channels, transposes and quantises in one listener
+// the stages are folded into a status table and a key table whenever one changes
+// so each byte is looked up once on its way into the outgoing list, which goes once
+// a note off or pressure goes to the channel and key its note on went to, even if the stages changed between
+// and a note off gets past the filter to a note that's sounding, so nothing's left hanging
+// a note goes out whole once its velocity's in, so its key moves into the next packet if that's where the velocity is
+// each packet out starts with a status, so running status never carries from one to the next
+// a setter waits for a Run() still using the old tables before it frees them
+// Run() keeps running status and sounding notes, so a pipeline listens to one input port
+
+class MIDICLPipeline
+	:
+	public MIDICLInputPortListener
+{
+	// public constructors/destructor
+	public:
+
+		// passes everything through untouched
+		MIDICLPipeline (MIDICLOutputPort *outPort);
+
+		~MIDICLPipeline ();
+
+	// MIDICLInputPortListener implementation
+	public:
+
+		void
+		Hear (const MIDIPacketList *inList);
+			// throws MIDICLException
+
+	// public methods
+	public:
+
+		// what Hear() does short of sending, into any builder
+		void
+		Run (const MIDIPacketList *inList, MIDICLPacketListBuilder &ioBuilder);
+			// throws MIDICLException
+
+		// the filter stage, bit n of inChannels passes channel n, 0-15
+		// bit n of inMessages passes status 0x80 + n * 0x10, bit 7 is everything system
+		void
+		SetFilter (UInt16 inChannels, Byte inMessages);
+
+		// the remap stage, both 0-15
+		void
+		SetChannelMap (Byte inFromChannel, Byte inToChannel);
+
+		// the transpose stage, in semitones
+		// notes that end up out of range move by octaves
+		void
+		SetTranspose (int inTranspose);
+
+		// the quantise stage, bit n of inScale is n semitones over inRoot
+		// an empty scale is taken to mean chromatic
+		void
+		SetScale (UInt16 inScale, Byte inRoot);
+
+	// private types
+	private:
+
+		struct Tables
+		{
+			// what each status byte becomes, 0 to drop the message
+			Byte	mStatuses [128];
+
+			// what each key of a note or poly aftertouch becomes
+			Byte	mKeys [128];
+		};
+
+		// where a note went
+		struct Note
+		{
+			// 0-15
+			Byte	mChannel;
+
+			// 0xff if it isn't sounding
+			Byte	mKey;
+		};
+
+	// private methods
+	private:
+
+		// Run() once it's counted itself in with these tables
+		void
+		Run (const Tables *inTables, const MIDIPacketList *inList, MIDICLPacketListBuilder &ioBuilder);
+			// throws MIDICLException
+
+		// with mMutex held
+		void
+		Publish ();
+
+	// private constructors
+	private:
+
+		MIDICLPipeline (const MIDICLPipeline &inCopy);
+
+	// private operators overloaded
+	private:
+
+		MIDICLPipeline &
+		operator = (const MIDICLPipeline &inCopy);
+
+	// private data
+	private:
+
+		MIDICLPacketListBuilder
+		mBuilder;
+
+		// setters only, Run() never waits on it
+		std::mutex
+		mMutex;
+
+		UInt16
+		mChannels;
+
+		Byte
+		mMessages;
+
+		Byte
+		mChannelMap [16];
+
+		int
+		mTranspose;
+
+		MIDICLScaleQuantiser
+		mQuantiser;
+
+		std::atomic<const Tables *>
+		mTables;
+
+		// which of mReaders a Run() starting now counts itself in
+		std::atomic<UInt32>
+		mEpoch;
+
+		// Run()s in progress in each epoch
+		std::atomic<UInt32>
+		mReaders [2];
+
+		// the rest belong to Run()
+
+		// running status carries on from packet to packet
+		Byte
+		mStatus;
+
+		// until the next status byte, notes aside
+		bool
+		mDropping;
+
+		// how many of the message's data bytes are in, 0 or 1
+		// the next one is a key when it's 0 and the message is a note
+		Byte
+		mDataCount;
+
+		// the key as it arrived, while we wait for the velocity
+		Byte
+		mKey;
+
+		// by channel and key as they arrived
+		Note
+		mSounding [16][128];
+};
+
+#endif	// MIDICLPipeline_h
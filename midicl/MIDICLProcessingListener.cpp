@@ -11,7 +11,7 @@
 MIDICLProcessingListener::MIDICLProcessingListener
 	(MIDICLOutputPort *outPort)
 	:
-	mOutputPort (outPort)
+	mBuilder (outPort)
 {
 }
 
@@ -20,42 +20,19 @@ MIDICLProcessingListener::MIDICLProcessingListener
 void
 MIDICLProcessingListener::Hear (const MIDIPacketList *inPacketList)
 {
-	Byte	outputPacketListBuffer [300];
-	Byte	outputPacketBuffer [300];
-
-	MIDIPacketList	*outputPacketList
-		((MIDIPacketList *) outputPacketListBuffer);
-
-	MIDIPacket	*outputPacket
-		(MIDIPacketListInit (outputPacketList));
-
 	const MIDIPacket	*inputPacket (inPacketList->packet);
 
 	for (UInt32	p = 0; p < inPacketList->numPackets;
 		p++, inputPacket = MIDIPacketNext (inputPacket))
 	{
 		// call the subclass to reprocess
-		UInt16	length = Process (inputPacket, outputPacketBuffer);
-
-		do
-		{
-			outputPacket = MIDIPacketListAdd
-				(outputPacketList, sizeof (outputPacketListBuffer),
-					outputPacket, 0, length, outputPacketBuffer);
-
-			if (outputPacket == NULL)
-			{
-				// send what we have
-				mOutputPort->SendPacketList (outputPacketList);
-
-				// reinitialise the packet list
-				outputPacket = MIDIPacketListInit (outputPacketList);
-			}
-		}
-		while (outputPacket == NULL);
+		// straight into the outgoing list
+		UInt16	length = Process (inputPacket, mBuilder.Reserve (inputPacket->length));
+
+		mBuilder.Commit (0, length);
 	}
 
 	// send whatever remains
-	mOutputPort->SendPacketList (outputPacketList);
+	mBuilder.Flush ();
 }
 
@@ -8,6 +8,7 @@
 // INCLUDES
 
 #include "MIDICLInputPortListener.h"
+#include "MIDICLPacketListBuilder.h"
 
 #include <CoreMIDI/MIDIServices.h>
 
@@ -18,6 +19,11 @@ struct MIDIPacketList;
 
 // CLASS
 
+// hands each packet to Process() and sends what comes out, a list for each list heard
+// the builder it goes into, and whatever a subclass keeps from one packet to the next,
+// follow one stream of lists, so a listener can only be added to one input port
+// CoreMIDI calls a port's read proc one list at a time, but different ports' at once
+
 class MIDICLProcessingListener
 	:
 	public MIDICLInputPortListener
@@ -30,6 +36,8 @@ class MIDICLProcessingListener
 	// public pure virtual methods
 	public:
 
+		// outOutputPacket has room for as many bytes as the input packet
+		// returns how many were written
 		virtual UInt16
 		Process (const MIDIPacket *inInputPacket, Byte *outOutputPacket) = 0;
 
@@ -42,8 +50,9 @@ class MIDICLProcessingListener
 	// private data
 	private:
 
-		MIDICLOutputPort *
-		mOutputPort;
+		// only Hear() uses it, for the one port
+		MIDICLPacketListBuilder
+		mBuilder;
 };
 
 #endif	// MIDICLProcessingListener_h
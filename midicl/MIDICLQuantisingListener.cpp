@@ -0,0 +1,103 @@
+// MIDICLQuantisingListener.cpp
+
+// INCLUDES
+
+#include "MIDICLQuantisingListener.h"
+
+#include "MIDICLClient.h"
+#include "MIDICLScaleQuantiser.h"
+
+#include <string.h>
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLQuantisingListener::MIDICLQuantisingListener
+	(MIDICLOutputPort *outPort, const MIDICLScaleQuantiser *inQuantiser)
+	:
+	MIDICLProcessingListener (outPort),
+	mQuantiser (inQuantiser),
+	mStatus (0),
+	mDataCount (0),
+	mKey (0),
+	mOutputKey (0)
+{
+	memset (mSounding, 0xff, sizeof (mSounding));
+}
+
+// MIDICLPROCESSINGLISTENER IMPLEMENTATION
+
+UInt16
+MIDICLQuantisingListener::Process (const MIDIPacket *inInputPacket, Byte *outOutputPacket)
+{
+	// where this packet's key went, if it's in this packet
+	Byte	*key = NULL;
+
+	for (UInt16 i = 0; i < inInputPacket->length; i++)
+	{
+		Byte	byte = inInputPacket->data [i];
+
+		outOutputPacket [i] = byte;
+
+		if (byte >= 0xf8)
+		{
+			// real time can turn up anywhere and changes nothing
+			continue;
+		}
+
+		if (byte >= 0x80)
+		{
+			// system common and sysex cancel running status
+			mStatus = byte < MIDICLClient::kMIDIStartSysExMessage ? byte : 0;
+			mDataCount = 0;
+			continue;
+		}
+
+		Byte	type = mStatus & 0xf0;
+
+		if (type != MIDICLClient::kMIDINoteOffMessage
+			&& type != MIDICLClient::kMIDINoteOnMessage
+			&& type != MIDICLClient::kMIDIPolyAftertouchMessage)
+		{
+			continue;
+		}
+
+		Byte	*sounding (mSounding [mStatus & 0xf]);
+
+		if (mDataCount == 0)
+		{
+			// whether it's on or off depends on the velocity still to come
+			// so a note on is assumed, and put right at the velocity if it wasn't
+			mKey = byte;
+			mOutputKey = sounding [byte] == 0xff || type == MIDICLClient::kMIDINoteOnMessage
+				? mQuantiser->Quantise (byte) : sounding [byte];
+
+			key = &outOutputPacket [i];
+			*key = mOutputKey;
+
+			mDataCount = 1;
+		}
+		else
+		{
+			if (type == MIDICLClient::kMIDINoteOnMessage && byte > 0)
+			{
+				sounding [mKey] = mOutputKey;
+			}
+			else if (type != MIDICLClient::kMIDIPolyAftertouchMessage)
+			{
+				// a note off, which goes where its note on did
+				// unless its key went out in an earlier packet, quantised as it is now
+				if (sounding [mKey] != 0xff && key != NULL)
+				{
+					*key = sounding [mKey];
+				}
+
+				sounding [mKey] = 0xff;
+			}
+
+			key = NULL;
+			mDataCount = 0;
+		}
+	}
+
+	return inInputPacket->length;
+}
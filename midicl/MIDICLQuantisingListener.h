@@ -0,0 +1,67 @@
+// MIDICLQuantisingListener.h
+
+// GUARD
+
+#ifndef MIDICLQuantisingListener_h
+#define MIDICLQuantisingListener_h
+
+// INCLUDES
+
+#include "MIDICLProcessingListener.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+// FORWARD DECLARATIONS
+
+class MIDICLOutputPort;
+class MIDICLScaleQuantiser;
+
+// CLASS
+
+// passes everything through with notes moved by a MIDICLScaleQuantiser
+// a note off goes to wherever its note on went, even if the scale changed between
+// unless the note off's key came in an earlier packet than its velocity, when it goes where the scale puts it now
+
+class MIDICLQuantisingListener
+	:
+	public MIDICLProcessingListener
+{
+	// public constructors/destructor
+	public:
+
+		MIDICLQuantisingListener (MIDICLOutputPort *outPort, const MIDICLScaleQuantiser *inQuantiser);
+
+	// MIDICLProcessingListener implementation
+	public:
+
+		UInt16
+		Process (const MIDIPacket *inInputPacket, Byte *outOutputPacket);
+
+	// private data
+	private:
+
+		const MIDICLScaleQuantiser *
+		mQuantiser;
+
+		// running status carries on from packet to packet
+		Byte
+		mStatus;
+
+		// how many data bytes of the current message we've seen
+		Byte
+		mDataCount;
+
+		// the key as it arrived, while we wait for the velocity
+		Byte
+		mKey;
+
+		// and where it went
+		Byte
+		mOutputKey;
+
+		// where each sounding key went, 0xff if it isn't sounding
+		Byte
+		mSounding [16][128];
+};
+
+#endif	// MIDICLQuantisingListener_h
@@ -0,0 +1,48 @@
+// MIDICLQueueingListener.cpp
+
+// INCLUDES
+
+#include "MIDICLQueueingListener.h"
+
+#include <mach/mach_time.h>
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLQueueingListener::MIDICLQueueingListener (MIDICLEventQueue *outQueue, UInt32 inSource)
+	:
+	mQueue (outQueue),
+	mSource (inSource)
+{
+}
+
+// MIDICLINPUTPORTLISTENER IMPLEMENTATION
+
+void
+MIDICLQueueingListener::Hear (const MIDIPacketList *inList)
+{
+	Handler	handler;
+
+	handler.mListener = this;
+	handler.mNow = mach_absolute_time ();
+
+	mParser.Parse (inList, handler);
+}
+
+// PRIVATE METHODS
+
+void
+MIDICLQueueingListener::Handler::Message (const MIDICLMessage &inMessage)
+{
+	MIDICLEventQueue::Event	event;
+
+	event.mMessage = inMessage;
+	event.mSource = mListener->mSource;
+
+	if (event.mMessage.mTimeStamp == 0)
+	{
+		event.mMessage.mTimeStamp = mNow;
+	}
+
+	// a full queue counts it
+	mListener->mQueue->Push (event);
+}
@@ -0,0 +1,75 @@
+// MIDICLQueueingListener.h
+
+// GUARD
+
+#ifndef MIDICLQueueingListener_h
+#define MIDICLQueueingListener_h
+
+// INCLUDES
+
+#include "MIDICLEventQueue.h"
+#include "MIDICLInputPortListener.h"
+#include "MIDICLParser.h"
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// parses what an input port hears into a MIDICLEventQueue and nothing else
+// so the read proc is done in a few hundred nanoseconds whatever the consumer's up to
+// one per port, they can all share a queue
+// messages stamped zero, meaning now, get the time they arrived
+// sysex doesn't fit in an event and isn't queued
+
+class MIDICLQueueingListener
+	:
+	public MIDICLInputPortListener
+{
+	// public constructors/destructor
+	public:
+
+		// inSource goes in every event, to tell the ports apart
+		MIDICLQueueingListener (MIDICLEventQueue *outQueue, UInt32 inSource);
+
+	// MIDICLInputPortListener implementation
+	public:
+
+		void
+		Hear (const MIDIPacketList *inList);
+
+	// private types
+	private:
+
+		// what the parser hands each message to
+		struct Handler
+		{
+			void
+			Message (const MIDICLMessage &inMessage);
+
+			void
+			SysEx (const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp)
+			{
+			}
+
+			MIDICLQueueingListener *
+			mListener;
+
+			// for the messages stamped zero
+			MIDITimeStamp
+			mNow;
+		};
+
+	// private data
+	private:
+
+		MIDICLEventQueue *
+		mQueue;
+
+		UInt32
+		mSource;
+
+		MIDICLParser
+		mParser;
+};
+
+#endif	// MIDICLQueueingListener_h
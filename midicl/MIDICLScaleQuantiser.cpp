@@ -0,0 +1,173 @@
+// MIDICLScaleQuantiser.cpp
+
+// INCLUDES
+
+#include "MIDICLScaleQuantiser.h"
+
+#include <string.h>
+
+// STATIC DATA
+
+struct NamedScale
+{
+	const char	*mName;
+	UInt16			mScale;
+};
+
+static const NamedScale
+sNamedScales [] =
+{
+	{ "chromatic", 0xfff },
+	{ "major", 0xab5 },
+	{ "minor", 0x5ad },
+	{ "dorian", 0x6ad },
+	{ "phrygian", 0x5ab },
+	{ "lydian", 0xad5 },
+	{ "mixolydian", 0x6b5 },
+	{ "locrian", 0x56b },
+	{ "harmonicminor", 0x9ad },
+	{ "melodicminor", 0xaad },
+	{ "pentatonic", 0x295 },
+	{ "minorpentatonic", 0x4a9 },
+	{ "blues", 0x4e9 },
+	{ "wholetone", 0x555 }
+};
+
+// PUBLIC CONSTRUCTORS/DESTRUCTOR
+
+MIDICLScaleQuantiser::MIDICLScaleQuantiser ()
+	:
+	mTable (nullptr),
+	mScale (0xfff),
+	mRoot (0),
+	mTranspose (0)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	Publish ();
+}
+
+// PUBLIC METHODS
+
+void
+MIDICLScaleQuantiser::SetScale (UInt16 inScale, Byte inRoot)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	inScale &= 0xfff;
+
+	mScale = inScale == 0 ? 0xfff : inScale;
+	mRoot = inRoot % 12;
+
+	Publish ();
+}
+
+void
+MIDICLScaleQuantiser::SetTranspose (int inTranspose)
+{
+	std::lock_guard<std::mutex>	lock (mMutex);
+
+	// further than this everything's folded back anyway
+	if (inTranspose > 127)
+	{
+		inTranspose = 127;
+	}
+	else if (inTranspose < -127)
+	{
+		inTranspose = -127;
+	}
+
+	mTranspose = inTranspose;
+
+	Publish ();
+}
+
+UInt16
+MIDICLScaleQuantiser::GetScale () const
+{
+	return mScale;
+}
+
+Byte
+MIDICLScaleQuantiser::GetRoot () const
+{
+	return mRoot;
+}
+
+int
+MIDICLScaleQuantiser::GetTranspose () const
+{
+	return mTranspose;
+}
+
+// STATIC PUBLIC METHODS
+
+bool
+MIDICLScaleQuantiser::GetNamedScale (const char *inName, UInt16 *outScale)
+{
+	for (size_t i = 0; i < sizeof (sNamedScales) / sizeof (sNamedScales [0]); i++)
+	{
+		if (strcmp (inName, sNamedScales [i].mName) == 0)
+		{
+			*outScale = sNamedScales [i].mScale;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// PRIVATE METHODS
+
+void
+MIDICLScaleQuantiser::Publish ()
+{
+	UInt32	key = mScale | (mRoot << 12) | ((UInt32) (mTranspose + 128) << 16);
+
+	std::unique_ptr<Byte []>	&table (mTables [key]);
+
+	if (!table)
+	{
+		table.reset (new Byte [128]);
+
+		for (int note = 0; note < 128; note++)
+		{
+			int	quantised = note;
+
+			// the nearest scale note, down rather than up on a tie
+			for (int distance = 0; distance < 12; distance++)
+			{
+				int	below = note - distance;
+				int	above = note + distance;
+
+				if (below >= 0 && (mScale & (1 << ((below - mRoot + 12) % 12))))
+				{
+					quantised = below;
+					break;
+				}
+
+				if (above <= 127 && (mScale & (1 << ((above - mRoot + 12) % 12))))
+				{
+					quantised = above;
+					break;
+				}
+			}
+
+			quantised += mTranspose;
+
+			while (quantised > 127)
+			{
+				quantised -= 12;
+			}
+
+			while (quantised < 0)
+			{
+				quantised += 12;
+			}
+
+			table [note] = quantised;
+		}
+	}
+
+	mTable.store (table.get (), std::memory_order_release);
+}
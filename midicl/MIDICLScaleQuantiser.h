@@ -0,0 +1,108 @@
+// MIDICLScaleQuantiser.h
+
+// GUARD
+
+#ifndef MIDICLScaleQuantiser_h
+#define MIDICLScaleQuantiser_h
+
+// INCLUDES
+
+#include <CoreMIDI/MIDIServices.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// CLASS
+
+// moves notes onto the nearest note of a scale, then transposes them
+// each scale, root and transpose gets a table of all 128 notes
+// built by whoever changes them, never by Quantise()
+// tables are kept until the quantiser goes, so one being read never goes away
+
+class MIDICLScaleQuantiser
+{
+	// public constructors/destructor
+	public:
+
+		// chromatic, not transposed
+		MIDICLScaleQuantiser ();
+
+	// public methods
+	public:
+
+		// bit n of inScale is n semitones over inRoot
+		// an empty scale is taken to mean chromatic
+		void
+		SetScale (UInt16 inScale, Byte inRoot);
+
+		// in semitones, notes that end up out of range move by octaves
+		void
+		SetTranspose (int inTranspose);
+
+		UInt16
+		GetScale () const;
+
+		Byte
+		GetRoot () const;
+
+		int
+		GetTranspose () const;
+
+		// from any thread
+		Byte
+		Quantise (Byte inNote) const
+		{
+			return mTable.load (std::memory_order_acquire) [inNote & 0x7f];
+		}
+
+	// static public methods
+	public:
+
+		// major, minor, dorian and so on, false if there's no such scale
+		static bool
+		GetNamedScale (const char *inName, UInt16 *outScale);
+
+	// private methods
+	private:
+
+		// with mMutex held
+		void
+		Publish ();
+
+	// private constructors
+	private:
+
+		MIDICLScaleQuantiser (const MIDICLScaleQuantiser &inCopy);
+
+	// private operators overloaded
+	private:
+
+		MIDICLScaleQuantiser &
+		operator = (const MIDICLScaleQuantiser &inCopy);
+
+	// private data
+	private:
+
+		std::mutex
+		mMutex;
+
+		// by scale, root and transpose
+		std::map<UInt32, std::unique_ptr<Byte []> >
+		mTables;
+
+		std::atomic<const Byte *>
+		mTable;
+
+		UInt16
+		mScale;
+
+		Byte
+		mRoot;
+
+		int
+		mTranspose;
+};
+
+#endif	// MIDICLScaleQuantiser_h
@@ -4,594 +4,454 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
-#include <dispatch/dispatch.h>
+#include <unistd.h>
 
 // language headers
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <thread>
 #include <vector>
 
 // library headers
 
 #include "MIDICLClient.h"
+#include "MIDICLEventQueue.h"
+#include "MIDICLInputPort.h"
 #include "MIDICLOutputPort.h"
+#include "MIDICLQuantisingListener.h"
+#include "MIDICLQueueingListener.h"
+#include "MIDICLScaleQuantiser.h"
+
+// sequencer headers
+
+#include "BatchRenderer.h"
+#include "ClockFollower.h"
+#include "HostTime.h"
+#include "LFOBank.h"
+#include "Modulation.h"
+#include "PatternBank.h"
+#include "PatternWatcher.h"
+#include "Random.h"
+#include "SMFImporter.h"
+#include "SMFWriter.h"
+#include "Sequence.h"
+#include "Sequencer.h"
+#include "SequencerOutput.h"
+#include "WorkRange.h"
+
+// imports files in parallel, one sequence per file
+// or with inMerge, every file is a take of the same sequence
+
+static int
+ImportFiles(const std::vector<const char *> &inPaths, bool inMerge, uint32_t inThreadCount,
+	std::vector<Sequence> &outSequences)
+{
+	uint32_t	fileCount = inPaths.size();
 
-// TIMER IMPLEMENTATION
+	inThreadCount = std::max(1u, std::min(inThreadCount, fileCount));
 
-#if !defined(MAC_OS_X_VERSION_10_12) || \
-    (MAC_OS_X_VERSION_MIN_REQUIRED < MAC_OS_X_VERSION_10_12)
-typedef int clockid_t;
-#endif
+	std::vector<WorkRange>	ranges(inThreadCount);
+	std::vector<uint8_t>		imported(fileCount);
+	std::vector<Sequence>		sequences(inMerge ? 1 : fileCount);
 
-struct itimerspec {
-    struct timespec it_interval;    /* timer period */
-    struct timespec it_value;       /* timer expiration */
-};
+	// one importer per worker, merged at the end if need be
+	std::vector<std::unique_ptr<SMFImporter> >	importers(inThreadCount);
 
-struct sigevent;
+	std::atomic<uint64_t>	eventCount(0);
+	std::atomic<uint64_t>	byteCount(0);
 
-/* If used a lot, queue should probably be outside of this struct */
-struct macos_timer {
-    dispatch_queue_t tim_queue;
-    dispatch_source_t tim_timer;
-    void (*tim_func)(union sigval);
-    void *tim_arg;
-};
+	DealWork(ranges, fileCount);
 
-typedef struct macos_timer *timer_t;
+	std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
 
-static inline void
-_timer_cancel(void *arg)
-{
-    struct macos_timer *tim = (struct macos_timer *)arg;
-    dispatch_release(tim->tim_timer);
-    dispatch_release(tim->tim_queue);
-    tim->tim_timer = NULL;
-    tim->tim_queue = NULL;
-    free(tim);
-}
+	auto	work = [&](uint32_t inWorkerNumber)
+	{
+		std::unique_ptr<SMFImporter>	importer(new SMFImporter);
+		uint32_t											fileNumber = 0;
 
-static inline void
-_timer_handler(void *arg)
-{
-    struct macos_timer *tim = (struct macos_timer *)arg;
-    union sigval sv;
+		while (TakeWork(ranges, inWorkerNumber, fileNumber))
+		{
+			if (!inMerge)
+				importer->Reset();
 
-    sv.sival_ptr = tim->tim_arg;
+			// each slot only ever has one writer
+			imported[fileNumber] = importer->Import(inPaths[fileNumber]);
 
-    if (tim->tim_func != NULL)
-        tim->tim_func(sv);
-}
+			if (!inMerge)
+			{
+				importer->MakeSequence(sequences[fileNumber]);
 
-static inline int
-timer_create(clockid_t clockid, struct sigevent *sevp,
-    timer_t *timerid)
-{
-    struct macos_timer *tim;
-
-    *timerid = NULL;
-
-    switch (clockid) {
-        case CLOCK_REALTIME:
-
-            /* What is implemented so far */
-            if (sevp->sigev_notify != SIGEV_THREAD) {
-                errno = ENOTSUP;
-                return (-1);
-            }
-
-            tim = (struct macos_timer *)
-                malloc(sizeof (struct macos_timer));
-            if (tim == NULL) {
-                errno = ENOMEM;
-                return (-1);
-            }
-
-            tim->tim_queue =
-                dispatch_queue_create("timerqueue",
-                0);
-            tim->tim_timer =
-                dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER,
-                0, 0, tim->tim_queue);
-
-            tim->tim_func = sevp->sigev_notify_function;
-            tim->tim_arg = sevp->sigev_value.sival_ptr;
-            *timerid = tim;
-
-            /* Opting to use pure C instead of Block versions */
-            dispatch_set_context(tim->tim_timer, tim);
-            dispatch_source_set_event_handler_f(tim->tim_timer,
-                _timer_handler);
-            dispatch_source_set_cancel_handler_f(tim->tim_timer,
-                _timer_cancel);
-
-            return (0);
-        default:
-            break;
-    }
-
-    errno = EINVAL;
-    return (-1);
-}
+				eventCount += importer->GetEventCount();
+				byteCount += importer->GetByteCount();
+			}
+		}
 
-static inline int
-timer_settime(timer_t tim, int flags,
-    const struct itimerspec *its, struct itimerspec *remainvalue)
-{
-    if (tim != NULL) {
-
-        /* Both zero, is disarm */
-        if (its->it_value.tv_sec == 0 &&
-            its->it_value.tv_nsec == 0) {
-        /* There's a comment about suspend count in Apple docs */
-            dispatch_suspend(tim->tim_timer);
-            return (0);
-        }
-
-        dispatch_time_t start;
-        start = dispatch_time(DISPATCH_TIME_NOW,
-            NSEC_PER_SEC * its->it_value.tv_sec +
-            its->it_value.tv_nsec);
-        dispatch_source_set_timer(tim->tim_timer, start,
-            NSEC_PER_SEC * its->it_value.tv_sec +
-            its->it_value.tv_nsec,
-            0);
-        dispatch_resume(tim->tim_timer);
-    }
-    return (0);
-}
+		importers[inWorkerNumber].swap(importer);
+	};
 
-static inline int
-timer_delete(timer_t tim)
-{
-    /* Calls _timer_cancel() */
-    if (tim != NULL)
-        dispatch_source_cancel(tim->tim_timer);
+	std::vector<std::thread>	threads;
 
-    return (0);
-}
-// UTILITY LOL
-
-class Utility
-{
-	public:
+	for (uint32_t workerNumber = 1; workerNumber < inThreadCount; workerNumber++)
+		threads.push_back(std::thread(work, workerNumber));
 
-		static bool
-		SelectProbability(uint8_t inProbability);
+	work(0);
 
-		template<typename T> static
-		T SelectValue(const T &inLower, const T &inUpper);
+	for (std::thread &thread : threads)
+		thread.join();
 
-};
+	if (inMerge)
+	{
+		for (uint32_t workerNumber = 1; workerNumber < inThreadCount; workerNumber++)
+			importers[0]->Merge(*importers[workerNumber]);
 
-bool Utility::SelectProbability(uint8_t inProbability)
-{
-	uint8_t	retval = 0;
+		importers[0]->MakeSequence(sequences[0]);
 
-	if (inProbability == 0)
-	{
-		retval = false;
-	}
-	else if (inProbability == 100)
-	{
-		retval = true;
-	}
-	else
-	{
-		retval = (random() % 100) < inProbability;
+		eventCount = importers[0]->GetEventCount();
+		byteCount = importers[0]->GetByteCount();
 	}
 
-	return retval;
-}
+	std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
 
-template<typename T>
-T Utility::SelectValue(const T &inLower, const T &inUpper)
-{
-	T	retval = 0;
-
-// fprintf(stderr, "select value from %d to %d\n", inLower, inUpper);
+	uint32_t	failedCount = 0;
 
-	if (inLower == inUpper)
+	for (uint32_t fileNumber = 0; fileNumber < fileCount; fileNumber++)
 	{
-		retval = inLower;
+		if (!imported[fileNumber])
+		{
+			fprintf(stderr, "could not import %s\n", inPaths[fileNumber]);
+			failedCount++;
+		}
 	}
-	else
-	{
-		int32_t	range = inUpper - inLower;
-		range = abs(range);
 
-		// random() gives 0..range so
-		range++;
+	printf("imported %u files (%llu events, %llu bytes) on %u threads in %.3fs (%.0f files/s, %.2f million events/s)\n",
+		fileCount - failedCount, (unsigned long long) eventCount.load(), (unsigned long long) byteCount.load(),
+		inThreadCount, elapsed.count(), fileCount / elapsed.count(), eventCount / elapsed.count() / 1000000.0);
 
-// fprintf(stderr, "range is %d\n", range);
+	outSequences.swap(sequences);
 
-		T	roll = (T) (random() % range);
-		retval = inLower + roll;
-	}
-
-	return retval;
+	return failedCount == fileCount ? 1 : 0;
 }
 
-// NOTE OPTION
+static void
+Usage()
+{
+	fprintf(stderr, "usage: sequencer [-seed n] [-threads n] [-import file.mid ... [-merge] | -bank file [-pattern n]]\n"
+		"                 [-writebank file] [-render file.mid [-format 0|1] [-bars n | -loops n] [-batch n]]\n"
+		"                 [-follow source] [-clock destination,...] [-control source,...]\n"
+		"                 [-scale name [-root n]] [-transpose n] [-thru source]\n"
+		"                 [-sweep controller] [-lfo shape,target,steps,depth ...]\n"
+		"       with -batch, a file name containing %%u gets one file per seed\n"
+		"       -import plays the first file's pattern, -merge treats all the files as takes of one\n"
+		"       -writebank writes the imported patterns, or those of -bank, or the built in one\n"
+		"       -follow plays to the clock on that source\n"
+		"       -clock sends clock and transport to those destinations\n"
+		"       -scale puts notes on a scale such as major, minor or dorian, with its root 0 to 11 semitones over C\n"
+		"       -thru plays notes from that source through the same scale and transpose\n"
+		"       -control switches pattern on program changes from those sources\n"
+		"       -sweep adds a lane that sweeps that controller over each pattern\n"
+		"       -lfo moves a range or probability such as noteupper or gatelower by up to depth,\n"
+		"       with a sine, triangle, sampleandhold or randomwalk taking that many steps a cycle\n");
+}
 
-struct NoteOption
+// renders the sequence offline to a Standard MIDI File
+static int
+Render(Sequencer &inSequencer, const char *inPath, uint16_t inFormat, uint32_t inTicks)
 {
-	// we need a constructor
-
-	NoteOption()
-		:
-		mProbability(100),
-		mNote(64),
-		mNoteLower(64),
-		mNoteUpper(64),
-		mVelocity(100),
-		mVelocityLower(100),
-		mVelocityUpper(100),
-		mGateTime(50),
-		mGateTimeLower(50),
-		mGateTimeUpper(50),
-		mRatchet(false),
-		mRatchetProbability(0),
-		mMute(false),
-		mMuteProbability(0),
-		mTie(false),
-		mTieProbability(0)
+	SMFWriter	writer;
+
+	if (!writer.Open(inPath, inFormat, (uint32_t) (60000000.0 / inSequencer.GetBPM())))
 	{
+		fprintf(stderr, "could not open %s\n", inPath);
+		return 1;
 	}
 
-	uint8_t	mProbability;
+	writer.BeginTrack("Sequence");
 
-	uint8_t	mNote;
-	uint8_t	mNoteLower;
-	uint8_t	mNoteUpper;
+	std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
 
-	uint8_t	mVelocity;
-	uint8_t	mVelocityLower;
-	uint8_t	mVelocityUpper;
+	inSequencer.Render(&writer, inTicks);
 
-	// percent of step length
-	int8_t	mGateTime;
-	int8_t	mGateTimeLower;
-	int8_t	mGateTimeUpper;
+	std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
 
-	bool	mRatchet;
-	uint8_t	mRatchetProbability;
-	
-	bool	mMute;
-	uint8_t	mMuteProbability;
+	writer.EndTrack();
 
-	bool	mTie;
-	uint8_t	mTieProbability;
+	if (!writer.Close())
+	{
+		fprintf(stderr, "error writing %s\n", inPath);
+		return 1;
+	}
 
-};
+	printf("rendered %llu events in %u ticks to %s in %.3fs (%.2f million events/s)\n",
+		(unsigned long long) writer.GetEventCount(), inTicks, inPath, elapsed.count(),
+		writer.GetEventCount() / elapsed.count() / 1000000.0);
 
-// STEP
+	return 0;
+}
 
-class Step
+// renders inCount variations seeded from inFirstSeed upwards
+static int
+RenderBatch(Sequencer &inSequencer, const char *inPath, uint64_t inFirstSeed, uint32_t inCount,
+	uint32_t inTicks, uint32_t inThreadCount)
 {
-	public:
+	BatchRenderer	renderer(inSequencer.GetSequence(), inSequencer.GetBPM(), inTicks, inSequencer.GetQuantiser());
 
-		Step()
-			:
-			mSelectedOption(nullptr),
-			mNoteOptions(2)
-		{
-		}
+	std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
 
-		NoteOption *
-		GetSelectedNoteOption()
-		{
-			return mSelectedOption;
-		}
+	bool	rendered = renderer.Render(inPath, inFirstSeed, inCount, inThreadCount);
 
-		void
-		SelectNoteOption();
+	std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
 
-		NoteOption &
-		GetNoteOption(uint32_t inOptionNumber)
-		{
-			return mNoteOptions[inOptionNumber];
-		}
+	if (!rendered)
+	{
+		fprintf(stderr, "error writing %s\n", inPath);
+		return 1;
+	}
 
-		const NoteOption &
-		GetNoteOption(uint32_t inOptionNumber) const
-		{
-			return mNoteOptions[inOptionNumber];
-		}
-		
-	private:
+	printf("rendered %u variations (%llu events) on %u threads in %.3fs (%.0f variations/s, %.2f million events/s)\n",
+		inCount, (unsigned long long) renderer.GetEventCount(), inThreadCount, elapsed.count(),
+		inCount / elapsed.count(), renderer.GetEventCount() / elapsed.count() / 1000000.0);
 
-		NoteOption								*mSelectedOption;
-		std::vector<NoteOption>		mNoteOptions;
-};
+	return 0;
+}
 
-void
-Step::SelectNoteOption()
+int main(int argc, const char *argv[])
 {
-	// how much validation here do we really need to do?
-	// remember that it's possible that we don't select an option at all
-
-	mSelectedOption = nullptr;
-
-	uint8_t	roll = (uint8_t) (random() % 100);
-	uint8_t	target = 0;
-
-	for (NoteOption &noteOption : mNoteOptions)
-	{
-		target += noteOption.mProbability;
-
-		if (roll < target)
-		{
-			mSelectedOption = &noteOption;
-			break;
-		}
-	}
+	Sequencer	sequencer;
 
-	// this is entirely possible and accepted
-	if (mSelectedOption == nullptr)
-		return;
+	const char	*renderPath = nullptr;
+	uint16_t		renderFormat = 1;
+	uint32_t		renderTicks = 0;
+	uint32_t		renderLoops = 0;
+	uint64_t		seed = time(nullptr);
+	uint32_t		batchCount = 0;
+	uint32_t		threadCount = std::max(1u, std::thread::hardware_concurrency());
 
-	// determine the property values
+	std::vector<const char *>	importPaths;
+	bool											merge = false;
 
-	mSelectedOption->mMute = Utility::SelectProbability(mSelectedOption->mMuteProbability);
-	mSelectedOption->mTie = Utility::SelectProbability(mSelectedOption->mTieProbability);
+	const char	*bankPath = nullptr;
+	const char	*writeBankPath = nullptr;
+	uint32_t		patternNumber = 0;
 
-	mSelectedOption->mGateTime = Utility::SelectValue<int8_t>
-		(mSelectedOption->mGateTimeLower, mSelectedOption->mGateTimeUpper);
+	int					followSource = -1;
 
-	mSelectedOption->mNote = Utility::SelectValue<uint8_t>
-		(mSelectedOption->mNoteLower, mSelectedOption->mNoteUpper);
+	std::vector<int>	clockDestinations;
 
-	mSelectedOption->mVelocity = Utility::SelectValue<uint8_t>
-		(mSelectedOption->mVelocityLower, mSelectedOption->mVelocityUpper);
+	MIDICLScaleQuantiser	quantiser;
+	const char						*scaleName = nullptr;
+	Byte									scaleRoot = 0;
+	int										transpose = 0;
+	int										thruSource = -1;
 
-	// wait, this way we only have one type of ratchet
-	// unless there is a ratchet granularity property
-	mSelectedOption->mRatchet = Utility::SelectProbability(mSelectedOption->mRatchetProbability);
-}
+	std::vector<int>	controlSources;
 
-// SEQUENCE
+	Modulation	modulation;
 
-class Sequence
-{
-	public:
-	
-		Sequence()
-			:
-			mSteps(16)
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-render") == 0 && i + 1 < argc)
 		{
+			renderPath = argv[++i];
 		}
-
-		NoteOption *
-		GetSelectedNoteOption(uint32_t inStepNumber)
+		else if (strcmp(argv[i], "-format") == 0 && i + 1 < argc)
 		{
-			return mSteps[inStepNumber].GetSelectedNoteOption();
+			renderFormat = atoi(argv[++i]) == 0 ? 0 : 1;
 		}
-
-		// this sets mSelectedOption in the step
-		void
-		SelectNoteOption(uint32_t inStepNumber);
-
-		Step &GetStep(uint32_t inStepNumber)
+		else if (strcmp(argv[i], "-bars") == 0 && i + 1 < argc)
 		{
-			return mSteps[inStepNumber];
+			renderTicks = strtoul(argv[++i], nullptr, 10) * kTicksPerBar;
 		}
-
-		const Step &GetStep(uint32_t inStepNumber) const
+		else if (strcmp(argv[i], "-loops") == 0 && i + 1 < argc)
 		{
-			return mSteps[inStepNumber];
+			renderLoops = strtoul(argv[++i], nullptr, 10);
 		}
+		else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+		{
+			seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "-batch") == 0 && i + 1 < argc)
+		{
+			batchCount = strtoul(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+		{
+			threadCount = std::max(1ul, strtoul(argv[++i], nullptr, 10));
+		}
+		else if (strcmp(argv[i], "-import") == 0 && i + 1 < argc)
+		{
+			while (i + 1 < argc && argv[i + 1][0] != '-')
+				importPaths.push_back(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-merge") == 0)
+		{
+			merge = true;
+		}
+		else if (strcmp(argv[i], "-bank") == 0 && i + 1 < argc)
+		{
+			bankPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "-pattern") == 0 && i + 1 < argc)
+		{
+			patternNumber = strtoul(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "-writebank") == 0 && i + 1 < argc)
+		{
+			writeBankPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "-follow") == 0 && i + 1 < argc)
+		{
+			followSource = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-clock") == 0 && i + 1 < argc)
+		{
+			const char	*list = argv[++i];
+			char				*end = nullptr;
 
-	private:
-	
-		std::vector<Step>	mSteps;
-};
-
-void
-Sequence::SelectNoteOption(uint32_t inStepNumber)
-{
-	GetStep(inStepNumber).SelectNoteOption();
-}
-
-// SEQUENCER
-
-class Sequencer
-{
-	public:
-	
-		Sequencer();
-
-		bool
-		Play(MIDICLOutputPort *inOutputPort);
-	
-		void
-		Stop();
-
-		void
-		SetBPM(float inBPM)
+			for (clockDestinations.push_back(strtol(list, &end, 10)); *end == ','; )
+				clockDestinations.push_back(strtol(end + 1, &end, 10));
+		}
+		else if (strcmp(argv[i], "-scale") == 0 && i + 1 < argc)
+		{
+			scaleName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-root") == 0 && i + 1 < argc)
+		{
+			scaleRoot = strtoul(argv[++i], nullptr, 10) % 12;
+		}
+		else if (strcmp(argv[i], "-transpose") == 0 && i + 1 < argc)
+		{
+			transpose = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-thru") == 0 && i + 1 < argc)
 		{
-			// this should update the clock tick ms too
+			thruSource = atoi(argv[++i]);
 		}
+		else if (strcmp(argv[i], "-control") == 0 && i + 1 < argc)
+		{
+			const char	*list = argv[++i];
+			char				*end = nullptr;
 
-		Sequence &
-		GetSequence()
+			for (controlSources.push_back(strtol(list, &end, 10)); *end == ','; )
+				controlSources.push_back(strtol(end + 1, &end, 10));
+		}
+		else if (strcmp(argv[i], "-sweep") == 0 && i + 1 < argc)
+		{
+			modulation.SetSweepController(strtoul(argv[++i], nullptr, 10) & 0x7f);
+		}
+		else if (strcmp(argv[i], "-lfo") == 0 && i + 1 < argc)
+		{
+			if (!modulation.AddLFO(argv[++i]))
+			{
+				fprintf(stderr, "bad lfo %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else
 		{
-			return mSequence;
+			Usage();
+			return 1;
 		}
+	}
 
-		uint32_t		mTimerTicks;
+	sequencer.Seed(seed);
 
-	private:
-	
-		static void TimerTickProc(union sigval inValue);
-
-		void TimerTick();
-
-		MIDICLOutputPort	*mOutputPort;
-		
-		int								mStepNumber;
-		Sequence					mSequence;
-		
-		// timer stuff
-		
-		timer_t						mTimer;
-		struct sigevent		mEvent;
-		struct itimerspec	mInterval;
-
-};
-
-Sequencer::Sequencer()
-	:
-	mStepNumber(0),
-	mTimerTicks(0),
-	mTimer(0)
-{
-}
+	if (scaleName)
+	{
+		UInt16	scale = 0;
 
-bool
-Sequencer::Play(MIDICLOutputPort *inOutputPort)
-{
-	mOutputPort = inOutputPort;
+		if (!MIDICLScaleQuantiser::GetNamedScale(scaleName, &scale))
+		{
+			fprintf(stderr, "no scale called %s\n", scaleName);
+			return 1;
+		}
+
+		quantiser.SetScale(scale, scaleRoot);
+	}
 
-	int	result = 0;
+	quantiser.SetTranspose(transpose);
 
-	mSequence.SelectNoteOption(0);
+	sequencer.SetQuantiser(&quantiser);
 
-	mTimer = 0;
-	mTimerTicks = 0;
+	std::vector<Sequence>	sequences;
+	PatternBank						bank;
 
-	mEvent.sigev_notify = SIGEV_THREAD;
-	mEvent.sigev_value.sival_ptr = (void *)this;
-	mEvent.sigev_notify_function = TimerTickProc;
-	mEvent.sigev_notify_attributes = NULL;
+	if (importPaths.size() > 0)
+	{
+		if (ImportFiles(importPaths, merge, threadCount, sequences) != 0)
+			return 1;
+	}
+	else if (bankPath)
+	{
+		std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
 
-	result = timer_create(CLOCK_REALTIME, &mEvent, &mTimer);
+		if (!bank.Open(bankPath))
+		{
+			fprintf(stderr, "could not open bank %s\n", bankPath);
+			return 1;
+		}
 
-	if (result)
-		return false;
-	
-	mInterval.it_value.tv_sec = 0;
-	mInterval.it_value.tv_nsec = 20833333;
+		if (!bank.LoadAll(sequences))
+		{
+			fprintf(stderr, "%s is damaged\n", bankPath);
+			return 1;
+		}
 
-	result = timer_settime(mTimer, 0, &mInterval, NULL);
+		// mapping it is the least of it, every pattern is checked and copied out
+		std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
 
-	if (result)
+		printf("loaded bank of %u patterns in %.3fms\n", bank.GetPatternCount(), elapsed.count() * 1000.0);
+	}
+	else
 	{
-		result = errno;
-		timer_delete(mTimer);
-		mTimer = 0;
-		return result;
+		sequences.resize(1);
+		sequences[0].SetUpDefault();
 	}
 
-	return true;
-}
+	if (writeBankPath)
+	{
+		if (!PatternBank::Write(writeBankPath, sequences))
+		{
+			fprintf(stderr, "could not write bank %s\n", writeBankPath);
+			return 1;
+		}
 
-void
-Sequencer::Stop()
-{
-	if (mTimer)
+		printf("wrote %u patterns to %s\n", (uint32_t) sequences.size(), writeBankPath);
+	}
+
+	if (sequences.size() == 0)
 	{
-		timer_delete(mTimer);
-		mTimer = 0;
+		fprintf(stderr, "no patterns\n");
+		return 1;
 	}
-}
 
-void
-Sequencer::TimerTickProc(union sigval inValue)
-{
-	Sequencer	*sequencer = (Sequencer *) inValue.sival_ptr;
-	sequencer->TimerTick();
-}
+	// after writing the bank, which has nowhere to keep lanes or LFOs
+	if (!modulation.Apply(sequences))
+	{
+		fprintf(stderr, "no more than %u lfos\n", LFOBank::kMaximumLFOs);
+		return 1;
+	}
 
-// this goes off at 24ppqn
-// HACK hardwire steps to quaver length
-void
-Sequencer::TimerTick()
-{
-	uint32_t		stepNumber = mTimerTicks / 12;
-	NoteOption	*selectedOption = mSequence.GetSelectedNoteOption(stepNumber);
+	sequencer.SetSequences(sequences, patternNumber);
 
-	if (selectedOption)
-	{
-		uint32_t	subtick = mTimerTicks % (24 / 2);
-	
-		switch(subtick)
-		{
-			// new step
-			case 0:
-				printf("step %u firing (ratchet? %d)\n", stepNumber, selectedOption->mRatchet);
-				mOutputPort->SendNoteOn(0, selectedOption->mNote, selectedOption->mVelocity);
-				break;
-			
-			// if ratcheting then turn off note 1 here
-			case 2:
-				if (selectedOption->mRatchet)
-					mOutputPort->SendNoteOff(0, selectedOption->mNote, selectedOption->mVelocity);
-				break;
-				
-			// if ratcheting then turn on note 2 here
-			case 3:
-				if (selectedOption->mRatchet)
-					mOutputPort->SendNoteOn(0, selectedOption->mNote, selectedOption->mVelocity);
-				break;
-				
-			// if ratcheting then turn off note 2 here
-			case 5:
-				if (selectedOption->mRatchet)
-					mOutputPort->SendNoteOff(0, selectedOption->mNote, selectedOption->mVelocity);
-				break;
-				
-			// if ratcheting then turn on note 3 here
-			case 6:
-				if (selectedOption->mRatchet)
-					mOutputPort->SendNoteOn(0, selectedOption->mNote, selectedOption->mVelocity);
-				break;
-
-			// if ratcheting then turn off note 3 here
-			case 8:
-				if (selectedOption->mRatchet)
-					mOutputPort->SendNoteOff(0, selectedOption->mNote, selectedOption->mVelocity);
-				break;
-			
-			// if ratcheting then turn on note 4 here
-			case 9:
-				if (selectedOption->mRatchet)
-					mOutputPort->SendNoteOn(0, selectedOption->mNote, selectedOption->mVelocity);
-				break;
-				
-			// if ratcheting then turn off note 4 here
-			case 11:
-				if (selectedOption->mRatchet)
-					mOutputPort->SendNoteOff(0, selectedOption->mNote, selectedOption->mVelocity);
-				
-				// and this is a good spot to calculate the next step's option
-				mSequence.SelectNoteOption((stepNumber + 1) % 16);
-				break;
-		}
+	uint32_t	loopTicks = sequencer.GetSequence().GetStepCount() * kTicksPerStep;
 
-		// now sort out whether to turn a non-ratchet note off
-		if (!selectedOption->mRatchet)
-		{
-			if (subtick == selectedOption->mGateTime / 12)
-				mOutputPort->SendNoteOff(0, selectedOption->mNote, selectedOption->mVelocity);
-		}
-	}
+	if (renderLoops)
+		renderTicks = renderLoops * loopTicks;
 
-	mTimerTicks++;
-	
-	// HACK hardwire to 16 steps
-	if (mTimerTicks / 12 == 16)
-		mTimerTicks = 0;
-}
+	// default to one loop
+	if (renderTicks == 0)
+		renderTicks = loopTicks;
 
-int main(int argc, const char *argv[])
-{
-	Sequencer	sequencer;
-	Sequence	&sequence(sequencer.GetSequence());
+	if (renderPath && batchCount)
+		return RenderBatch(sequencer, renderPath, seed, batchCount, renderTicks, threadCount);
 
-	srandom(time(nullptr));
+	if (renderPath)
+		return Render(sequencer, renderPath, renderFormat, renderTicks);
 
 	MIDICLClient	client(CFSTR("AssQuencer"));
 
@@ -620,30 +480,176 @@ int main(int argc, const char *argv[])
 	MIDICLOutputPort	*outputPort(client.MakeOutputPort(CFSTR ("AssQuencer Output")));
 	outputPort->SetDestination(destinationRef);
 
-	// set up our sequence
-	for (uint32_t stepNumber = 0; stepNumber < 16; stepNumber++)
+	// clock and transport go out on their own ports
+	// so they can go to things that aren't playing notes
+	std::vector<MIDICLOutputPort *>	clockPorts;
+
+	for (int clockDestination : clockDestinations)
 	{
-		Step	&step(sequence.GetStep(stepNumber));
+		MIDICLOutputPort	*clockPort(client.MakeOutputPort(CFSTR ("AssQuencer Clock")));
+		clockPort->SetDestination(MIDIGetDestination(clockDestination));
 
-		step.GetNoteOption(0).mNoteLower = 40;
-		step.GetNoteOption(0).mNoteUpper = 60;
-		step.GetNoteOption(0).mGateTimeLower = 70;
-		step.GetNoteOption(0).mGateTimeUpper = 80;
-		step.GetNoteOption(0).mProbability = 90;
-	
-		step.GetNoteOption(1).mNoteLower = 50;
-		step.GetNoteOption(1).mNoteUpper = 50;
-		step.GetNoteOption(1).mProbability = 25;
-		step.GetNoteOption(1).mRatchetProbability = 100;
+		clockPorts.push_back(clockPort);
+
+		printf("sending clock to destination %d\n", clockDestination);
+	}
+
+	sequencer.SetClockPorts(clockPorts);
+
+	// edits to the bank show up at the end of the loop
+	std::unique_ptr<PatternWatcher>	watcher;
+
+	if (bankPath)
+		watcher.reset(new PatternWatcher(&sequencer, bankPath, &modulation));
+
+	// notes played in come out on the same scale as the sequence
+	std::unique_ptr<MIDICLQuantisingListener>	thru;
+
+	if (thruSource >= 0)
+	{
+		thru.reset(new MIDICLQuantisingListener(outputPort, &quantiser));
+
+		MIDICLInputPort	*thruPort(client.MakeInputPort(CFSTR ("AssQuencer Thru")));
+		thruPort->SetSource(MIDIGetSource(thruSource));
+		thruPort->SetListener(thru.get());
+
+		printf("playing notes from source %d through the scale\n", thruSource);
 	}
 
-	if (sequencer.Play(outputPort))
+	// program changes from any of these pick the pattern
+	// every port's read proc only parses into the queue, the tick does the rest
+	MIDICLEventQueue	controlQueue;
+
+	std::vector<std::unique_ptr<MIDICLQueueingListener> >	controlListeners;
+
+	for (int controlSource : controlSources)
+	{
+		controlListeners.emplace_back(new MIDICLQueueingListener(&controlQueue, controlListeners.size()));
+
+		MIDICLInputPort	*controlPort(client.MakeInputPort(CFSTR ("AssQuencer Control")));
+		controlPort->SetSource(MIDIGetSource(controlSource));
+		controlPort->SetListener(controlListeners.back().get());
+
+		printf("taking program changes from source %d\n", controlSource);
+	}
+
+	if (controlSources.size() > 0)
+		sequencer.SetInputQueue(&controlQueue);
+
+	// slaved to a drum machine or whatever on that source
+	ClockFollower	follower;
+	bool					started = false;
+
+	if (followSource >= 0)
+	{
+		MIDICLInputPort	*inputPort(client.MakeInputPort(CFSTR ("AssQuencer Clock")));
+		inputPort->SetSource(MIDIGetSource(followSource));
+		inputPort->SetListener(&follower);
+
+		printf("following clock from source %d\n", followSource);
+
+		started = sequencer.Follow(outputPort, &follower);
+	}
+	else
+	{
+		started = sequencer.Play(outputPort);
+	}
+
+	if (started)
 	{
-		sleep(10);
+		if (watcher)
+			watcher->Start();
+
+		if (sequencer.GetSequenceCount() > 1 || watcher || followSource >= 0 || clockPorts.size() > 0
+			|| scaleName || thruSource >= 0 || controlSources.size() > 0)
+		{
+			printf("%u patterns, enter n to switch to pattern n at the next bar,\n"
+				"n l to switch at the end of the loop, s to stop, c to continue, p to play from the top,\n"
+				"b n or t n to go to bar or step n, k name n for scale name on root n, x n to transpose by n,\n"
+				"or q to quit\n",
+				sequencer.GetSequenceCount());
+
+			char	line[64];
+
+			while (fgets(line, sizeof(line), stdin) && line[0] != 'q')
+			{
+				if (line[0] == 's' && followSource < 0)
+				{
+					sequencer.Stop();
+					sequencer.GetClockStats().Print();
+					continue;
+				}
+
+				if (line[0] == 'c' && followSource < 0)
+				{
+					if (!sequencer.Continue())
+						printf("already playing\n");
+
+					continue;
+				}
+
+				if (line[0] == 'p' && followSource < 0)
+				{
+					sequencer.Play(outputPort);
+					continue;
+				}
+
+				if (line[0] == 'k')
+				{
+					char		name[32];
+					int			root = 0;
+					UInt16	scale = 0;
+
+					if (sscanf(line + 1, "%31s %d", name, &root) < 1
+						|| !MIDICLScaleQuantiser::GetNamedScale(name, &scale))
+					{
+						printf("no scale %s", line + 1);
+						continue;
+					}
+
+					// built here, the tick only ever looks notes up
+					quantiser.SetScale(scale, (Byte) (((root % 12) + 12) % 12));
+					continue;
+				}
+
+				if (line[0] == 'x')
+				{
+					quantiser.SetTranspose(atoi(line + 1));
+					continue;
+				}
+
+				if ((line[0] == 'b' || line[0] == 't') && followSource < 0)
+				{
+					uint32_t	number = strtoul(line + 1, nullptr, 10);
+
+					sequencer.Locate(number * (line[0] == 'b' ? kTicksPerBar : kTicksPerStep));
+					continue;
+				}
+
+				char			*end = nullptr;
+				uint32_t	number = strtoul(line, &end, 10);
+
+				Sequencer::SwitchPoint	switchPoint = strchr(end, 'l')
+					? Sequencer::kSwitchAtLoop : Sequencer::kSwitchAtBar;
+
+				if (end == line || !sequencer.QueueSequence(number, switchPoint))
+					printf("no pattern %s", line);
+			}
+		}
+		else
+		{
+			sleep(10);
+		}
+
+		if (watcher)
+			watcher->Stop();
 	
 		sequencer.Stop();
 	
 		printf("sequencer received %d timer ticks\n", sequencer.mTimerTicks);
+
+		if (followSource < 0)
+			sequencer.GetClockStats().Print();
 	}
 	else
 	{
@@ -1,5 +1,4 @@
 #!/bin/bash
 
-g++ --std=c++11 -Imidicl sequencer.cpp -framework CoreMIDI -framework CoreFoundation -L midicl/lib/ -lmidicl -o sequencer
-
+g++ --std=c++11 -Imidicl -Isrc sequencer.cpp src/*.cpp -framework CoreMIDI -framework CoreFoundation -L midicl/lib/ -lmidicl -o sequencer
 
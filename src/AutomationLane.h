@@ -0,0 +1,51 @@
+// AutomationLane.h
+
+// GUARD
+
+#ifndef AutomationLane_h
+#define AutomationLane_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// a controller or pitch bend value for each step, sent as the step starts
+// a step without one leaves it where it was
+// interpolating, each value slides to the next step's over the step
+
+struct AutomationLane
+{
+	enum Type
+	{
+		kControlChange,
+		kPitchBend
+	};
+
+	static const int16_t	kNoValue = -1;
+
+	AutomationLane(uint32_t inStepCount = 16)
+		:
+		mType(kControlChange),
+		mChannel(0),
+		mController(0),
+		mInterpolate(false),
+		mValues(inStepCount, (int16_t) kNoValue)
+	{
+	}
+
+	uint8_t	mType;
+	Byte		mChannel;
+	Byte		mController;
+	bool		mInterpolate;
+
+	// 0 to 127 for a controller, 0 to 16383 for pitch bend
+	std::vector<int16_t>	mValues;
+};
+
+#endif	// AutomationLane_h
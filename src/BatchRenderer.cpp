@@ -0,0 +1,134 @@
+// BatchRenderer.cpp
+
+// INCLUDES
+
+#include "BatchRenderer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <memory>
+#include <thread>
+
+#include "Sequence.h"
+#include "Sequencer.h"
+
+BatchRenderer::BatchRenderer(const Sequence &inPattern, float inBPM, uint32_t inTicks,
+	const MIDICLScaleQuantiser *inQuantiser)
+	:
+	mPattern(inPattern),
+	mBPM(inBPM),
+	mTicks(inTicks),
+	mQuantiser(inQuantiser),
+	mPath(nullptr),
+	mSeedFormat(nullptr),
+	mFirstSeed(0),
+	mEventCount(0),
+	mError(false)
+{
+}
+
+bool
+BatchRenderer::Render(const char *inPath, uint64_t inFirstSeed, uint32_t inCount, uint32_t inThreadCount)
+{
+	mPath = inPath;
+	mSeedFormat = inPath ? strstr(inPath, "%u") : nullptr;
+	mFirstSeed = inFirstSeed;
+	mEventCount = 0;
+	mError = false;
+
+	if (mPath && mSeedFormat == nullptr)
+	{
+		if (!mWriter.Open(mPath, 1, (uint32_t) (60000000.0 / mBPM)))
+			return false;
+	}
+
+	std::vector<std::vector<Byte> >	tracks(mPath && mSeedFormat == nullptr ? inCount : 0);
+
+	mTracks.swap(tracks);
+
+	std::vector<WorkRange>	ranges(inThreadCount);
+
+	mRanges.swap(ranges);
+	DealWork(mRanges, inCount);
+
+	std::vector<std::thread>	threads;
+
+	for (uint32_t workerNumber = 1; workerNumber < inThreadCount; workerNumber++)
+		threads.push_back(std::thread(&BatchRenderer::Work, this, workerNumber));
+
+	Work(0);
+
+	for (std::thread &thread : threads)
+		thread.join();
+
+	if (mPath && mSeedFormat == nullptr)
+	{
+		// in seed order whichever worker finished first
+		for (std::vector<Byte> &track : mTracks)
+		{
+			mWriter.AppendTrack(track.data(), track.size());
+
+			std::vector<Byte>().swap(track);
+		}
+
+		if (!mWriter.Close())
+			mError = true;
+	}
+
+	return !mError;
+}
+
+void
+BatchRenderer::Work(uint32_t inWorkerNumber)
+{
+	Sequencer									sequencer;
+	std::unique_ptr<SMFWriter>	writer(new SMFWriter);
+	std::vector<Byte>					scratch;
+	uint64_t									eventCount = 0;
+
+	sequencer.GetSequence() = mPattern;
+	sequencer.SetBPM(mBPM);
+	sequencer.SetQuantiser(mQuantiser);
+
+	uint32_t	number = 0;
+
+	while (TakeWork(mRanges, inWorkerNumber, number))
+	{
+		uint64_t	seed = mFirstSeed + number;
+		char			name[32];
+
+		snprintf(name, sizeof(name), "seed %llu", (unsigned long long) seed);
+
+		sequencer.Seed(seed);
+
+		if (mSeedFormat)
+		{
+			char	path[1024];
+
+			snprintf(path, sizeof(path), "%.*s%llu%s", (int) (mSeedFormat - mPath), mPath,
+				(unsigned long long) seed, mSeedFormat + 2);
+
+			if (!writer->Open(path, 1, (uint32_t) (60000000.0 / mBPM)))
+			{
+				mError = true;
+				continue;
+			}
+		}
+		else
+		{
+			writer->OpenTracks(mPath ? &mTracks[number] : &scratch);
+		}
+
+		writer->BeginTrack(name);
+		sequencer.Render(writer.get(), mTicks);
+		writer->EndTrack();
+
+		if (!writer->Close())
+			mError = true;
+
+		eventCount += writer->GetEventCount();
+	}
+
+	mEventCount += eventCount;
+}
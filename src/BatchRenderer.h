@@ -0,0 +1,76 @@
+// BatchRenderer.h
+
+// GUARD
+
+#ifndef BatchRenderer_h
+#define BatchRenderer_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
+#include "SMFWriter.h"
+#include "WorkRange.h"
+
+// FORWARD DECLARATIONS
+
+class MIDICLScaleQuantiser;
+class Sequence;
+
+// CLASS
+
+// renders many independently seeded variations of one pattern
+// every worker has its own sequencer, random and writer
+// the only things shared are the work ranges and, for one file, a track per seed
+// which go into it in seed order once every worker's done
+
+class BatchRenderer
+{
+	public:
+
+		// every worker shares inQuantiser, which can be null
+		BatchRenderer(const Sequence &inPattern, float inBPM, uint32_t inTicks,
+			const MIDICLScaleQuantiser *inQuantiser = nullptr);
+
+		// a path containing %u writes one file per seed
+		// any other path gets one format 1 file with a track per seed
+		// no path renders to memory only, for timing
+		bool
+		Render(const char *inPath, uint64_t inFirstSeed, uint32_t inCount, uint32_t inThreadCount);
+
+		uint64_t
+		GetEventCount() const
+		{
+			return mEventCount;
+		}
+
+	private:
+
+		void
+		Work(uint32_t inWorkerNumber);
+
+		const Sequence					&mPattern;
+		float										mBPM;
+		uint32_t								mTicks;
+
+		const MIDICLScaleQuantiser	*mQuantiser;
+
+		const char							*mPath;
+		const char							*mSeedFormat;
+		uint64_t								mFirstSeed;
+
+		std::vector<WorkRange>	mRanges;
+
+		SMFWriter								mWriter;
+
+		// by seed, each written by whichever worker took it
+		std::vector<std::vector<Byte> >	mTracks;
+
+		std::atomic<uint64_t>		mEventCount;
+		std::atomic<bool>				mError;
+};
+
+#endif	// BatchRenderer_h
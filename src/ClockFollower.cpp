@@ -0,0 +1,46 @@
+// ClockFollower.cpp
+
+// INCLUDES
+
+#include "ClockFollower.h"
+
+#include <CoreMIDI/CoreMIDI.h>
+
+#include "HostTime.h"
+
+void
+ClockFollower::Hear(const MIDIPacketList *inList)
+{
+	const MIDIPacket	*packet = &inList->packet[0];
+
+	for (UInt32 packetNumber = 0; packetNumber < inList->numPackets; packetNumber++)
+	{
+		// zero means now
+		uint64_t	time = packet->timeStamp ? HostTime::ToNanoseconds(packet->timeStamp) : HostTime::Now();
+
+		// real time bytes can turn up anywhere, even in the middle of other messages
+		for (UInt16 byteNumber = 0; byteNumber < packet->length; byteNumber++)
+		{
+			switch (packet->data[byteNumber])
+			{
+				case 0xf8:
+					Push(kClock, time);
+					break;
+
+				case 0xfa:
+					Push(kStart, time);
+					break;
+
+				case 0xfb:
+					Push(kContinue, time);
+					break;
+
+				case 0xfc:
+					Push(kStop, time);
+					break;
+			}
+		}
+
+		packet = MIDIPacketNext(packet);
+	}
+}
@@ -0,0 +1,107 @@
+// ClockFollower.h
+
+// GUARD
+
+#ifndef ClockFollower_h
+#define ClockFollower_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "MIDICLInputPortListener.h"
+
+// CLASS
+
+// picks clock and transport out of whatever arrives on an input port
+// Hear() runs on the CoreMIDI thread and only ever writes the ring
+// the sequencer's follow thread is the only reader
+
+class ClockFollower
+	:
+	public MIDICLInputPortListener
+{
+	public:
+
+		enum EventType
+		{
+			kClock,
+			kStart,
+			kContinue,
+			kStop
+		};
+
+		struct Event
+		{
+			uint64_t	mTime;
+			uint32_t	mType;
+		};
+
+		ClockFollower()
+			:
+			mWrite(0),
+			mRead(0),
+			mDropped(0)
+		{
+		}
+
+		void
+		Hear(const MIDIPacketList *inList);
+
+		// the follow thread's end
+		bool
+		Pop(Event &outEvent)
+		{
+			uint32_t	read = mRead.load(std::memory_order_relaxed);
+
+			if (read == mWrite.load(std::memory_order_acquire))
+				return false;
+
+			outEvent = mRing[read % kRingSize];
+
+			mRead.store(read + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		// events that arrived with the ring full
+		uint32_t
+		GetDroppedCount() const
+		{
+			return mDropped.load(std::memory_order_relaxed);
+		}
+
+	private:
+
+		void
+		Push(uint32_t inType, uint64_t inTime)
+		{
+			uint32_t	write = mWrite.load(std::memory_order_relaxed);
+
+			if (write - mRead.load(std::memory_order_acquire) == kRingSize)
+			{
+				mDropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			mRing[write % kRingSize].mTime = inTime;
+			mRing[write % kRingSize].mType = inType;
+
+			mWrite.store(write + 1, std::memory_order_release);
+		}
+
+		// five seconds of clock at 120bpm
+		static const uint32_t	kRingSize = 256;
+
+		Event	mRing[kRingSize];
+
+		// free running counts, apart so the two threads don't share a line
+		alignas(64) std::atomic<uint32_t>	mWrite;
+		alignas(64) std::atomic<uint32_t>	mRead;
+
+		std::atomic<uint32_t>	mDropped;
+};
+
+#endif	// ClockFollower_h
@@ -0,0 +1,58 @@
+// ClockPLL.cpp
+
+// INCLUDES
+
+#include "ClockPLL.h"
+
+bool
+ClockPLL::Pulse(uint64_t inTime)
+{
+	bool	jumped = false;
+
+	if (mPulses == 0)
+	{
+		mAnchorTime = inTime;
+		mFirstTime = inTime;
+		mFirstPulse = 0;
+	}
+	else
+	{
+		uint64_t	predicted = GetTime(mPulses);
+		double		error = (double) (int64_t) (inTime - predicted);
+
+		if (error > mPeriod / 2 || error < -mPeriod / 2)
+		{
+			// way off the guess, or the tempo jumped, so start again from the last pulse
+			if (inTime > mLastTime)
+				mPeriod = (double) (inTime - mLastTime);
+
+			mAnchorTime = inTime;
+			mFirstTime = mLastTime;
+			mFirstPulse = mPulses - 1;
+
+			// the guess being off doesn't count
+			jumped = mPulses > 1;
+		}
+		else if (mPulses - mFirstPulse < kAcquirePulses)
+		{
+			mAnchorTime = predicted + (int64_t) (error * kPhaseGain);
+			mPeriod = (double) (inTime - mFirstTime) / (mPulses - mFirstPulse);
+		}
+		else
+		{
+			mAnchorTime = predicted + (int64_t) (error * kPhaseGain);
+			mPeriod += error * kPeriodGain;
+		}
+
+		if (mPeriod < kMinimumPeriod)
+			mPeriod = kMinimumPeriod;
+		else if (mPeriod > kMaximumPeriod)
+			mPeriod = kMaximumPeriod;
+	}
+
+	mAnchorPulse = mPulses;
+	mLastTime = inTime;
+	mPulses++;
+
+	return jumped;
+}
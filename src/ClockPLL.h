@@ -0,0 +1,82 @@
+// ClockPLL.h
+
+// GUARD
+
+#ifndef ClockPLL_h
+#define ClockPLL_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+// CLASS
+
+// smooths the arrival times of clock pulses into a steady grid
+// for the first beat the period is the average of every interval so far
+// after that it's second order, so the phase follows each pulse a little
+// and the period follows the phase error a little less
+
+class ClockPLL
+{
+	public:
+
+		// inPeriod is nanoseconds per pulse, the guess until pulses arrive
+		ClockPLL(double inPeriod)
+			:
+			mPeriod(inPeriod),
+			mAnchorTime(0),
+			mAnchorPulse(0),
+			mFirstTime(0),
+			mFirstPulse(0),
+			mLastTime(0),
+			mPulses(0)
+		{
+		}
+
+		// pulses count from zero again, the period carries over
+		void
+		Reset()
+		{
+			mPulses = 0;
+		}
+
+		// true if the tempo jumped and the loop started again
+		bool
+		Pulse(uint64_t inTime);
+
+		// when pulse number inPulse falls on the smoothed grid
+		uint64_t
+		GetTime(uint32_t inPulse) const
+		{
+			return mAnchorTime + (int64_t) ((int32_t) (inPulse - mAnchorPulse) * mPeriod);
+		}
+
+		double
+		GetPeriod() const
+		{
+			return mPeriod;
+		}
+
+	private:
+
+		// a beat at 24ppqn
+		static const uint32_t	kAcquirePulses = 24;
+
+		// 1/8 phase with a critically damped period gain
+		static constexpr double	kPhaseGain = 0.125;
+		static constexpr double	kPeriodGain = 0.004;
+
+		// 250bpm to 10bpm at 24ppqn
+		static constexpr double	kMinimumPeriod = 10000000.0;
+		static constexpr double	kMaximumPeriod = 250000000.0;
+
+		double		mPeriod;
+		uint64_t	mAnchorTime;
+		uint32_t	mAnchorPulse;
+		uint64_t	mFirstTime;
+		uint32_t	mFirstPulse;
+		uint64_t	mLastTime;
+		uint32_t	mPulses;
+};
+
+#endif	// ClockPLL_h
@@ -0,0 +1,71 @@
+// HostTime.h
+
+// GUARD
+
+#ifndef HostTime_h
+#define HostTime_h
+
+// INCLUDES
+
+#include <stdint.h>
+#include <mach/mach_time.h>
+
+// CLASS
+
+// mach absolute time, which is what CoreMIDI timestamps are in
+// everything outside this class works in nanoseconds
+
+class HostTime
+{
+	public:
+
+		static uint64_t
+		Now()
+		{
+			return ToNanoseconds(mach_absolute_time());
+		}
+
+		static uint64_t
+		ToNanoseconds(uint64_t inHostTime)
+		{
+			const mach_timebase_info_data_t	&timebase(GetTimebase());
+
+			return inHostTime * timebase.numer / timebase.denom;
+		}
+
+		static uint64_t
+		FromNanoseconds(uint64_t inNanoseconds)
+		{
+			const mach_timebase_info_data_t	&timebase(GetTimebase());
+
+			return inNanoseconds * timebase.denom / timebase.numer;
+		}
+
+		static void
+		WaitUntil(uint64_t inNanoseconds)
+		{
+			mach_wait_until(FromNanoseconds(inNanoseconds));
+		}
+
+	private:
+
+		static const mach_timebase_info_data_t &
+		GetTimebase()
+		{
+			static mach_timebase_info_data_t	sTimebase = MakeTimebase();
+
+			return sTimebase;
+		}
+
+		static mach_timebase_info_data_t
+		MakeTimebase()
+		{
+			mach_timebase_info_data_t	timebase;
+
+			mach_timebase_info(&timebase);
+
+			return timebase;
+		}
+};
+
+#endif	// HostTime_h
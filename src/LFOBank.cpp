@@ -0,0 +1,176 @@
+// LFOBank.cpp
+
+// INCLUDES
+
+#include "LFOBank.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "Utility.h"
+
+static const char	*sLFOShapeNames[LFOBank::kShapeCount] =
+{
+	"sine",
+	"triangle",
+	"sampleandhold",
+	"randomwalk"
+};
+
+static const char	*sLFOTargetNames[LFOBank::kTargetCount] =
+{
+	"notelower",
+	"noteupper",
+	"velocitylower",
+	"velocityupper",
+	"gatelower",
+	"gateupper",
+	"probability",
+	"muteprobability",
+	"tieprobability",
+	"ratchetprobability"
+};
+
+LFOBank::LFOBank()
+	:
+	mCount(0)
+{
+	memset(mPhases, 0, sizeof(mPhases));
+	memset(mIncrements, 0, sizeof(mIncrements));
+	memset(mDepths, 0, sizeof(mDepths));
+	memset(mHeld, 0, sizeof(mHeld));
+	memset(mValues, 0, sizeof(mValues));
+	memset(mShapes, 0, sizeof(mShapes));
+	memset(mTargets, 0, sizeof(mTargets));
+}
+
+bool
+LFOBank::Add(uint8_t inShape, uint8_t inTarget, uint32_t inPeriod, int inDepth)
+{
+	if (mCount == kMaximumLFOs || inShape >= kShapeCount || inTarget >= kTargetCount)
+		return false;
+
+	// a period of one would never leave phase zero
+	if (inPeriod < 2)
+		inPeriod = 2;
+
+	mIncrements[mCount] = (uint32_t) ((1ULL << 32) / inPeriod);
+	mDepths[mCount] = Utility::Clamp(inDepth, -kMaximumDepth, kMaximumDepth);
+	mShapes[mCount] = inShape;
+	mTargets[mCount] = inTarget;
+	mCount++;
+
+	Reset();
+
+	return true;
+}
+
+void
+LFOBank::Reset()
+{
+	// a step short of the start, so the next one lands on it
+	// and the sample and holds see it as a new cycle
+	for (uint32_t lfo = 0; lfo < kMaximumLFOs; lfo++)
+		mPhases[lfo] = 0 - mIncrements[lfo];
+
+	memset(mHeld, 0, sizeof(mHeld));
+}
+
+void
+LFOBank::Advance(Random &inRandom, int16_t outOffsets[kTargetCount])
+{
+	uint8_t	wrapped[kMaximumLFOs];
+
+	for (uint32_t lfo = 0; lfo < kMaximumLFOs; lfo++)
+	{
+		uint32_t	phase = mPhases[lfo] + mIncrements[lfo];
+
+		wrapped[lfo] = phase < mPhases[lfo];
+		mPhases[lfo] = phase;
+	}
+
+	// only these roll, so banks without them leave the sequence's rolls alone
+	for (uint32_t lfo = 0; lfo < mCount; lfo++)
+	{
+		if (mShapes[lfo] == kSampleAndHold)
+		{
+			if (wrapped[lfo])
+				mHeld[lfo] = (int32_t) inRandom.Below(65535) - 32767;
+		}
+		else if (mShapes[lfo] == kRandomWalk)
+		{
+			// about a cycle to wander from one end to the other
+			int32_t	reach = (mIncrements[lfo] >> 15) + 1;
+
+			mHeld[lfo] = Utility::Clamp
+				(mHeld[lfo] + (int32_t) inRandom.Below(2 * reach + 1) - reach, -32767, 32767);
+		}
+	}
+
+	const Waves	&waves = GetWaves();
+
+	for (uint32_t lfo = 0; lfo < kMaximumLFOs; lfo++)
+	{
+		int32_t	value = waves.mWaves[mShapes[lfo]][mPhases[lfo] >> 24] + mHeld[lfo];
+
+		mValues[lfo] = (value * mDepths[lfo] + 16384) >> 15;
+	}
+
+	memset(outOffsets, 0, kTargetCount * sizeof(outOffsets[0]));
+
+	for (uint32_t lfo = 0; lfo < mCount; lfo++)
+		outOffsets[mTargets[lfo]] += mValues[lfo];
+}
+
+bool
+LFOBank::GetNamedShape(const char *inName, uint8_t *outShape)
+{
+	for (uint8_t shape = 0; shape < kShapeCount; shape++)
+	{
+		if (strcmp(inName, sLFOShapeNames[shape]) == 0)
+		{
+			*outShape = shape;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool
+LFOBank::GetNamedTarget(const char *inName, uint8_t *outTarget)
+{
+	for (uint8_t target = 0; target < kTargetCount; target++)
+	{
+		if (strcmp(inName, sLFOTargetNames[target]) == 0)
+		{
+			*outTarget = target;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const LFOBank::Waves &
+LFOBank::GetWaves()
+{
+	static Waves	sWaves;
+
+	return sWaves;
+}
+
+LFOBank::Waves::Waves()
+{
+	memset(mWaves, 0, sizeof(mWaves));
+
+	for (int index = 0; index < 256; index++)
+	{
+		mWaves[kSine][index] = (int16_t) lround(32767.0 * sin(2.0 * M_PI * index / 256.0));
+
+		// up to the top a quarter in, down to the bottom at three quarters
+		int	triangle = index < 64 ? index : (index < 192 ? 128 - index : index - 256);
+
+		mWaves[kTriangle][index] = (int16_t) (triangle * 32767 / 64);
+	}
+}
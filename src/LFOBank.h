@@ -0,0 +1,106 @@
+// LFOBank.h
+
+// GUARD
+
+#ifndef LFOBank_h
+#define LFOBank_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include "Random.h"
+
+// CLASS
+
+// LFOs that move note option ranges and probabilities as a pattern plays
+// each field is its own array, so moving every LFO on is a few flat loops
+// the compiler can vectorise rather than a call per LFO per parameter
+// phase is a 32 bit fraction of a cycle, its top 8 bits index the wavetable
+
+class LFOBank
+{
+	public:
+
+		enum Shape
+		{
+			kSine,
+			kTriangle,
+			kSampleAndHold,
+			kRandomWalk,
+			kShapeCount
+		};
+
+		// what Step::SelectNoteOption() adds each one to
+		enum Target
+		{
+			kNoteLower,
+			kNoteUpper,
+			kVelocityLower,
+			kVelocityUpper,
+			kGateTimeLower,
+			kGateTimeUpper,
+			kProbability,
+			kMuteProbability,
+			kTieProbability,
+			kRatchetProbability,
+			kTargetCount
+		};
+
+		static const uint32_t	kMaximumLFOs = 16;
+		static const int			kMaximumDepth = 255;
+
+		LFOBank();
+
+		// inPeriod in steps, inDepth in the target's units at the top of the wave
+		// false if the bank is full
+		bool
+		Add(uint8_t inShape, uint8_t inTarget, uint32_t inPeriod, int inDepth);
+
+		uint32_t
+		GetCount() const
+		{
+			return mCount;
+		}
+
+		// every LFO back to the start of its cycle
+		void
+		Reset();
+
+		// moves every LFO on a step and sums what each target gets
+		void
+		Advance(Random &inRandom, int16_t outOffsets[kTargetCount]);
+
+		static bool
+		GetNamedShape(const char *inName, uint8_t *outShape);
+
+		static bool
+		GetNamedTarget(const char *inName, uint8_t *outTarget);
+
+	private:
+
+		// a cycle of each shape out of 32767
+		// the random ones are flat, what they hold is in mHeld
+		struct Waves
+		{
+			Waves();
+
+			int16_t	mWaves[kShapeCount][256];
+		};
+
+		static const Waves &
+		GetWaves();
+
+		uint32_t	mCount;
+
+		// unused slots have no depth, so the loops can always run the lot
+		uint32_t	mPhases[kMaximumLFOs];
+		uint32_t	mIncrements[kMaximumLFOs];
+		int32_t		mDepths[kMaximumLFOs];
+		int32_t		mHeld[kMaximumLFOs];
+		int32_t		mValues[kMaximumLFOs];
+		uint8_t		mShapes[kMaximumLFOs];
+		uint8_t		mTargets[kMaximumLFOs];
+};
+
+#endif	// LFOBank_h
@@ -0,0 +1,56 @@
+// MappedFile.cpp
+
+// INCLUDES
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+bool
+MappedFile::Open(const char *inPath)
+{
+	Close();
+
+	int	fd = open(inPath, O_RDONLY);
+
+	if (fd < 0)
+		return false;
+
+	struct stat	status;
+
+	if (fstat(fd, &status) != 0 || status.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void	*data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping keeps its own reference to the file
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	madvise(data, status.st_size, MADV_SEQUENTIAL);
+
+	mData = (const Byte *) data;
+	mLength = status.st_size;
+
+	return true;
+}
+
+void
+MappedFile::Close()
+{
+	if (mData)
+	{
+		munmap((void *) mData, mLength);
+
+		mData = nullptr;
+		mLength = 0;
+	}
+}
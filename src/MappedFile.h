@@ -0,0 +1,63 @@
+// MappedFile.h
+
+// GUARD
+
+#ifndef MappedFile_h
+#define MappedFile_h
+
+// INCLUDES
+
+#include <stddef.h>
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// a whole file mapped read only
+
+class MappedFile
+{
+	public:
+
+		MappedFile()
+			:
+			mData(nullptr),
+			mLength(0)
+		{
+		}
+
+		~MappedFile()
+		{
+			Close();
+		}
+
+		bool
+		Open(const char *inPath);
+
+		void
+		Close();
+
+		const Byte *
+		GetData() const
+		{
+			return mData;
+		}
+
+		size_t
+		GetLength() const
+		{
+			return mLength;
+		}
+
+	private:
+
+		MappedFile(const MappedFile &inCopy);
+
+		MappedFile &
+		operator=(const MappedFile &inCopy);
+
+		const Byte	*mData;
+		size_t			mLength;
+};
+
+#endif	// MappedFile_h
@@ -0,0 +1,74 @@
+// Modulation.cpp
+
+// INCLUDES
+
+#include "Modulation.h"
+
+#include <stdio.h>
+
+#include "AutomationLane.h"
+#include "LFOBank.h"
+#include "Sequence.h"
+
+Modulation::Modulation()
+	:
+	mSweepController(-1)
+{
+}
+
+void
+Modulation::SetSweepController(int inController)
+{
+	mSweepController = inController;
+}
+
+bool
+Modulation::AddLFO(const char *inSpec)
+{
+	char		shapeName[32];
+	char		targetName[32];
+	LFOSpec	lfo;
+
+	lfo.mPeriod = 0;
+	lfo.mDepth = 0;
+
+	if (sscanf(inSpec, "%31[^,],%31[^,],%u,%d", shapeName, targetName, &lfo.mPeriod, &lfo.mDepth) != 4
+		|| !LFOBank::GetNamedShape(shapeName, &lfo.mShape) || !LFOBank::GetNamedTarget(targetName, &lfo.mTarget))
+	{
+		return false;
+	}
+
+	mLFOs.push_back(lfo);
+
+	return true;
+}
+
+bool
+Modulation::Apply(std::vector<Sequence> &ioSequences) const
+{
+	for (Sequence &sequence : ioSequences)
+	{
+		// up over the loop and back down across its last step
+		if (mSweepController >= 0)
+		{
+			uint32_t				stepCount = sequence.GetStepCount();
+			AutomationLane	lane(stepCount);
+
+			lane.mController = mSweepController;
+			lane.mInterpolate = true;
+
+			for (uint32_t stepNumber = 0; stepNumber < stepCount; stepNumber++)
+				lane.mValues[stepNumber] = stepCount > 1 ? 127 * stepNumber / (stepCount - 1) : 0;
+
+			sequence.GetLanes().push_back(lane);
+		}
+
+		for (const LFOSpec &lfo : mLFOs)
+		{
+			if (!sequence.GetLFOs().Add(lfo.mShape, lfo.mTarget, lfo.mPeriod, lfo.mDepth))
+				return false;
+		}
+	}
+
+	return true;
+}
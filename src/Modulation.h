@@ -0,0 +1,56 @@
+// Modulation.h
+
+// GUARD
+
+#ifndef Modulation_h
+#define Modulation_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <vector>
+
+// FORWARD DECLARATIONS
+
+class Sequence;
+
+// CLASS
+
+// the sweep lane and LFOs -sweep and -lfo put on every pattern
+// a bank has nowhere to keep them, so they go on again each time patterns are loaded
+// by the PatternWatcher too, and once set up they're only read
+
+class Modulation
+{
+	public:
+
+		Modulation();
+
+		// -1 for no sweep
+		void
+		SetSweepController(int inController);
+
+		// shape,target,period in steps,depth, false if it doesn't read as one
+		bool
+		AddLFO(const char *inSpec);
+
+		// false if there are more LFOs than a pattern can take
+		bool
+		Apply(std::vector<Sequence> &ioSequences) const;
+
+	private:
+
+		struct LFOSpec
+		{
+			uint8_t		mShape;
+			uint8_t		mTarget;
+			uint32_t	mPeriod;
+			int				mDepth;
+		};
+
+		int										mSweepController;
+		std::vector<LFOSpec>	mLFOs;
+};
+
+#endif	// Modulation_h
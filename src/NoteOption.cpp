@@ -0,0 +1,64 @@
+// NoteOption.cpp
+
+// INCLUDES
+
+#include "NoteOption.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+uint32_t
+NoteOption::GetChordNotes(Byte inNote, Byte *outNotes) const
+{
+	if (mChordIntervals == 0)
+	{
+		outNotes[0] = inNote;
+		return 1;
+	}
+
+	int				notes[kMaximumChordNotes];
+	uint32_t	noteCount = 0;
+
+	notes[noteCount++] = inNote;
+
+	for (int interval = 1; interval < (int) kMaximumChordNotes; interval++)
+	{
+		if (mChordIntervals & (1 << interval))
+			notes[noteCount++] = inNote + interval;
+	}
+
+	// rotating keeps the lowest at the front
+	for (uint32_t inversion = 0; inversion < mInversion; inversion++)
+	{
+		int	lowest = notes[0];
+
+		memmove(notes, notes + 1, (noteCount - 1) * sizeof(notes[0]));
+		notes[noteCount - 1] = lowest + 12;
+	}
+
+	// voicing can fold two notes onto one key, which only sounds once
+	uint64_t	used[2] = { 0, 0 };
+	uint32_t	count = 0;
+
+	for (uint32_t noteNumber = 0; noteNumber < noteCount; noteNumber++)
+	{
+		int	note = notes[noteNumber];
+
+		while (note < mVoicingLower && note + 12 <= 127)
+			note += 12;
+
+		while (note > mVoicingUpper && note - 12 >= 0)
+			note -= 12;
+
+		note = std::min(std::max(note, 0), 127);
+
+		if ((used[note >> 6] & (1ULL << (note & 63))) == 0)
+		{
+			used[note >> 6] |= 1ULL << (note & 63);
+			outNotes[count++] = note;
+		}
+	}
+
+	return count;
+}
@@ -0,0 +1,106 @@
+// NoteOption.h
+
+// GUARD
+
+#ifndef NoteOption_h
+#define NoteOption_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+struct NoteOption
+{
+	// we need a constructor
+
+	NoteOption()
+		:
+		mProbability(100),
+		mNote(64),
+		mNoteLower(64),
+		mNoteUpper(64),
+		mVelocity(100),
+		mVelocityLower(100),
+		mVelocityUpper(100),
+		mGateTime(50),
+		mGateTimeLower(50),
+		mGateTimeUpper(50),
+		mRatchet(false),
+		mRatchetProbability(0),
+		mRatchetCount(4),
+		mRatchetSpacing(3),
+		mRatchetDecay(0),
+		mMute(false),
+		mMuteProbability(0),
+		mTie(false),
+		mTieProbability(0),
+		mChordIntervals(0),
+		mInversion(0),
+		mInversionLower(0),
+		mInversionUpper(0),
+		mVoicingLower(0),
+		mVoicingUpper(127)
+	{
+	}
+
+	// the root and every interval, the most GetChordNotes() can return
+	static const uint32_t	kMaximumChordNotes = 25;
+
+	// inNote, which is usually the selected note, and the chord on it, inverted and voiced
+	// returns how many there are, never fewer than one
+	uint32_t
+	GetChordNotes(Byte inNote, Byte *outNotes) const;
+
+	uint8_t	mProbability;
+
+	uint8_t	mNote;
+	uint8_t	mNoteLower;
+	uint8_t	mNoteUpper;
+
+	uint8_t	mVelocity;
+	uint8_t	mVelocityLower;
+	uint8_t	mVelocityUpper;
+
+	// percent of step length, over 100 runs into the next step
+	int16_t	mGateTime;
+	int16_t	mGateTimeLower;
+	int16_t	mGateTimeUpper;
+
+	bool	mRatchet;
+	uint8_t	mRatchetProbability;
+
+	// hits in a ratchet, 1 to 16
+	uint8_t	mRatchetCount;
+
+	// ticks from one hit to the next, 1 to 24
+	// each hit lets go a tick before the next one
+	uint8_t	mRatchetSpacing;
+
+	// percent of the velocity each hit loses on the one before
+	uint8_t	mRatchetDecay;
+	
+	bool	mMute;
+	uint8_t	mMuteProbability;
+
+	bool	mTie;
+	uint8_t	mTieProbability;
+
+	// bit n sounds n semitones over the note, up to two octaves
+	// zero plays the note on its own
+	uint32_t	mChordIntervals;
+
+	// how many times the lowest note goes up an octave
+	uint8_t	mInversion;
+	uint8_t	mInversionLower;
+	uint8_t	mInversionUpper;
+
+	// chord notes outside this move by octaves until they're in it
+	uint8_t	mVoicingLower;
+	uint8_t	mVoicingUpper;
+};
+
+#endif	// NoteOption_h
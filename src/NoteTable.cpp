@@ -0,0 +1,33 @@
+// NoteTable.cpp
+
+// INCLUDES
+
+#include "NoteTable.h"
+
+uint32_t
+NoteTable::TakeNoteOffs(Byte *outBytes)
+{
+	uint32_t	length = 0;
+
+	for (Byte channel = 0; channel < 16; channel++)
+	{
+		if ((mChannels & (1 << channel)) == 0)
+			continue;
+
+		for (Byte half = 0; half < 2; half++)
+		{
+			for (uint64_t notes = mNotes[channel][half]; notes != 0; notes &= notes - 1)
+			{
+				outBytes[length++] = 0x80 | channel;
+				outBytes[length++] = (half << 6) | __builtin_ctzll(notes);
+				outBytes[length++] = 0x40;
+			}
+
+			mNotes[channel][half] = 0;
+		}
+	}
+
+	mChannels = 0;
+
+	return length;
+}
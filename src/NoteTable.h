@@ -0,0 +1,71 @@
+// NoteTable.h
+
+// GUARD
+
+#ifndef NoteTable_h
+#define NoteTable_h
+
+// INCLUDES
+
+#include <stdint.h>
+#include <string.h>
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// a bit for every note on every channel, set while it's sounding
+// so stopping can turn off exactly what's on rather than all 2048
+
+class NoteTable
+{
+	public:
+
+		// the most TakeNoteOffs() can write
+		static const uint32_t	kMaximumNoteOffBytes = 16 * 128 * 3;
+
+		NoteTable()
+		{
+			Clear();
+		}
+
+		void
+		NoteOn(Byte inChannel, Byte inKey)
+		{
+			mNotes[inChannel & 0xf][(inKey >> 6) & 1] |= 1ULL << (inKey & 63);
+			mChannels |= 1 << (inChannel & 0xf);
+		}
+
+		void
+		NoteOff(Byte inChannel, Byte inKey)
+		{
+			mNotes[inChannel & 0xf][(inKey >> 6) & 1] &= ~(1ULL << (inKey & 63));
+		}
+
+		bool
+		IsSounding(Byte inChannel, Byte inKey) const
+		{
+			return (mNotes[inChannel & 0xf][(inKey >> 6) & 1] & (1ULL << (inKey & 63))) != 0;
+		}
+
+		void
+		Clear()
+		{
+			memset(mNotes, 0, sizeof(mNotes));
+			mChannels = 0;
+		}
+
+		// a note off for each sounding note into outBytes, which then all count as off
+		// returns the number of bytes written
+		uint32_t
+		TakeNoteOffs(Byte *outBytes);
+
+	private:
+
+		uint64_t	mNotes[16][2];
+
+		// channels that have had a note on since the last take
+		uint16_t	mChannels;
+};
+
+#endif	// NoteTable_h
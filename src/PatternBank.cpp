@@ -0,0 +1,232 @@
+// PatternBank.cpp
+
+// INCLUDES
+
+#include "PatternBank.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "Sequence.h"
+
+bool
+PatternBank::Open(const char *inPath)
+{
+	mHeader = nullptr;
+
+	if (!mFile.Open(inPath) || mFile.GetLength() < sizeof(BankHeader))
+		return false;
+
+	const BankHeader	*header = (const BankHeader *) mFile.GetData();
+
+	if (memcmp(header->mMagic, "SQBK", 4) != 0 || header->mVersion != kVersion
+		|| header->mHeaderSize != sizeof(BankHeader)
+		|| header->mHeaderChecksum != Checksum(header, offsetof(BankHeader, mHeaderChecksum)))
+	{
+		return false;
+	}
+
+	if (header->mStepCount != kBankStepCount || header->mNoteOptionCount != kBankNoteOptionCount
+		|| header->mPatternSize != sizeof(BankPattern))
+	{
+		return false;
+	}
+
+	uint64_t	checksumEnd = header->mChecksumOffset + (uint64_t) header->mPatternCount * sizeof(uint32_t);
+	uint64_t	patternEnd = header->mPatternOffset + (uint64_t) header->mPatternCount * header->mPatternSize;
+
+	if (checksumEnd > mFile.GetLength() || patternEnd > mFile.GetLength()
+		|| header->mChecksumOffset % 4 != 0 || header->mPatternOffset % 4 != 0)
+	{
+		return false;
+	}
+
+	mChecksums = (const uint32_t *) (mFile.GetData() + header->mChecksumOffset);
+
+	if (header->mTableChecksum != Checksum(mChecksums, header->mPatternCount * sizeof(uint32_t)))
+		return false;
+
+	mPatterns = (const BankPattern *) (mFile.GetData() + header->mPatternOffset);
+	mHeader = header;
+
+	return true;
+}
+
+const BankPattern *
+PatternBank::GetPattern(uint32_t inPatternNumber) const
+{
+	if (inPatternNumber >= GetPatternCount())
+		return nullptr;
+
+	const BankPattern	*pattern = mPatterns + inPatternNumber;
+
+	if (Checksum(pattern, sizeof(BankPattern)) != mChecksums[inPatternNumber])
+		return nullptr;
+
+	return pattern;
+}
+
+bool
+PatternBank::Verify() const
+{
+	for (uint32_t patternNumber = 0; patternNumber < GetPatternCount(); patternNumber++)
+	{
+		if (GetPattern(patternNumber) == nullptr)
+			return false;
+	}
+
+	return mHeader != nullptr;
+}
+
+bool
+PatternBank::LoadAll(std::vector<Sequence> &outSequences) const
+{
+	outSequences.resize(GetPatternCount());
+
+	for (uint32_t patternNumber = 0; patternNumber < GetPatternCount(); patternNumber++)
+	{
+		const BankPattern	*pattern = GetPattern(patternNumber);
+
+		if (pattern == nullptr)
+			return false;
+
+		Load(*pattern, outSequences[patternNumber]);
+	}
+
+	return mHeader != nullptr;
+}
+
+bool
+PatternBank::Write(const char *inPath, const std::vector<Sequence> &inSequences)
+{
+	uint32_t	patternCount = inSequences.size();
+
+	BankHeader	header;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.mMagic, "SQBK", 4);
+
+	header.mVersion = kVersion;
+	header.mHeaderSize = sizeof(BankHeader);
+	header.mPatternCount = patternCount;
+	header.mStepCount = kBankStepCount;
+	header.mNoteOptionCount = kBankNoteOptionCount;
+	header.mPatternSize = sizeof(BankPattern);
+	header.mChecksumOffset = sizeof(BankHeader);
+
+	// patterns start on a 16 byte boundary
+	header.mPatternOffset = (header.mChecksumOffset + patternCount * sizeof(uint32_t) + 15) & ~15u;
+
+	std::vector<uint32_t>			checksums(patternCount);
+	std::vector<BankPattern>	patterns(patternCount);
+
+	for (uint32_t patternNumber = 0; patternNumber < patternCount; patternNumber++)
+	{
+		Store(inSequences[patternNumber], patterns[patternNumber]);
+		checksums[patternNumber] = Checksum(&patterns[patternNumber], sizeof(BankPattern));
+	}
+
+	header.mTableChecksum = Checksum(checksums.data(), patternCount * sizeof(uint32_t));
+	header.mHeaderChecksum = Checksum(&header, offsetof(BankHeader, mHeaderChecksum));
+
+	// into a file of its own, renamed over the bank once it's all there
+	// so anything with the bank mapped keeps the old file rather than seeing it cut short
+	std::string	temporaryPath(std::string(inPath) + ".tmp");
+
+	FILE	*file = fopen(temporaryPath.c_str(), "wb");
+
+	if (file == nullptr)
+		return false;
+
+	static const Byte	padding[16] = { 0 };
+
+	uint32_t	paddingLength = header.mPatternOffset - header.mChecksumOffset - patternCount * sizeof(uint32_t);
+
+	bool	written = fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(checksums.data(), sizeof(uint32_t), patternCount, file) == patternCount
+		&& fwrite(padding, 1, paddingLength, file) == paddingLength
+		&& fwrite(patterns.data(), sizeof(BankPattern), patternCount, file) == patternCount;
+
+	if (fclose(file) != 0)
+		written = false;
+
+	if (!written || rename(temporaryPath.c_str(), inPath) != 0)
+	{
+		unlink(temporaryPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+void
+PatternBank::Load(const BankPattern &inPattern, Sequence &outSequence)
+{
+	for (uint32_t stepNumber = 0; stepNumber < kBankStepCount; stepNumber++)
+	{
+		for (uint32_t optionNumber = 0; optionNumber < kBankNoteOptionCount; optionNumber++)
+		{
+			const BankNoteOption	&stored(inPattern.mNoteOptions[stepNumber][optionNumber]);
+			NoteOption						&noteOption(outSequence.GetStep(stepNumber).GetNoteOption(optionNumber));
+
+			noteOption = NoteOption();
+
+			noteOption.mProbability = stored.mProbability;
+			noteOption.mNoteLower = stored.mNoteLower;
+			noteOption.mNoteUpper = stored.mNoteUpper;
+			noteOption.mVelocityLower = stored.mVelocityLower;
+			noteOption.mVelocityUpper = stored.mVelocityUpper;
+			noteOption.mGateTimeLower = stored.mGateTimeLower;
+			noteOption.mGateTimeUpper = stored.mGateTimeUpper;
+			noteOption.mRatchetProbability = stored.mRatchetProbability;
+			noteOption.mMuteProbability = stored.mMuteProbability;
+			noteOption.mTieProbability = stored.mTieProbability;
+
+			noteOption.mRatchetCount = stored.mRatchetCount;
+			noteOption.mRatchetSpacing = stored.mRatchetSpacing;
+			noteOption.mRatchetDecay = stored.mRatchetDecay;
+			noteOption.mInversionLower = stored.mInversionLower;
+			noteOption.mInversionUpper = stored.mInversionUpper;
+			noteOption.mVoicingLower = stored.mVoicingLower;
+			noteOption.mVoicingUpper = stored.mVoicingUpper;
+			noteOption.mChordIntervals = stored.mChordIntervals;
+		}
+	}
+}
+
+void
+PatternBank::Store(const Sequence &inSequence, BankPattern &outPattern)
+{
+	memset(&outPattern, 0, sizeof(outPattern));
+
+	for (uint32_t stepNumber = 0; stepNumber < kBankStepCount; stepNumber++)
+	{
+		for (uint32_t optionNumber = 0; optionNumber < kBankNoteOptionCount; optionNumber++)
+		{
+			const NoteOption	&noteOption(inSequence.GetStep(stepNumber).GetNoteOption(optionNumber));
+			BankNoteOption		&stored(outPattern.mNoteOptions[stepNumber][optionNumber]);
+
+			stored.mProbability = noteOption.mProbability;
+			stored.mNoteLower = noteOption.mNoteLower;
+			stored.mNoteUpper = noteOption.mNoteUpper;
+			stored.mVelocityLower = noteOption.mVelocityLower;
+			stored.mVelocityUpper = noteOption.mVelocityUpper;
+			stored.mRatchetProbability = noteOption.mRatchetProbability;
+			stored.mMuteProbability = noteOption.mMuteProbability;
+			stored.mTieProbability = noteOption.mTieProbability;
+			stored.mRatchetCount = noteOption.mRatchetCount;
+			stored.mRatchetSpacing = noteOption.mRatchetSpacing;
+			stored.mRatchetDecay = noteOption.mRatchetDecay;
+			stored.mInversionLower = noteOption.mInversionLower;
+			stored.mInversionUpper = noteOption.mInversionUpper;
+			stored.mVoicingLower = noteOption.mVoicingLower;
+			stored.mVoicingUpper = noteOption.mVoicingUpper;
+			stored.mGateTimeLower = noteOption.mGateTimeLower;
+			stored.mGateTimeUpper = noteOption.mGateTimeUpper;
+			stored.mChordIntervals = noteOption.mChordIntervals;
+		}
+	}
+}
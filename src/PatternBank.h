@@ -0,0 +1,171 @@
+// PatternBank.h
+
+// GUARD
+
+#ifndef PatternBank_h
+#define PatternBank_h
+
+// INCLUDES
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <CoreMIDI/MIDIServices.h>
+
+#include "MappedFile.h"
+
+// FORWARD DECLARATIONS
+
+class Sequence;
+
+// CONSTANTS
+
+// a versioned fixed layout file of patterns, mapped and copied out field by field with nothing to parse
+// header, then a checksum per pattern, then the patterns themselves
+// everything is little endian, which is all we run on
+// only the chosen ranges and probabilities are stored, not the last selection
+
+static const uint32_t	kBankStepCount = 16;
+static const uint32_t	kBankNoteOptionCount = 2;
+
+struct BankNoteOption
+{
+	uint8_t		mProbability;
+
+	uint8_t		mNoteLower;
+	uint8_t		mNoteUpper;
+
+	uint8_t		mVelocityLower;
+	uint8_t		mVelocityUpper;
+
+	uint8_t		mRatchetProbability;
+	uint8_t		mMuteProbability;
+	uint8_t		mTieProbability;
+
+	uint8_t		mRatchetCount;
+	uint8_t		mRatchetSpacing;
+	uint8_t		mRatchetDecay;
+
+	uint8_t		mInversionLower;
+	uint8_t		mInversionUpper;
+	uint8_t		mVoicingLower;
+	uint8_t		mVoicingUpper;
+
+	uint8_t		mPadding;
+
+	// percent of step length
+	int16_t		mGateTimeLower;
+	int16_t		mGateTimeUpper;
+
+	uint32_t	mChordIntervals;
+
+	// zero, room to grow without moving anything
+	uint8_t		mReserved[8];
+};
+
+struct BankPattern
+{
+	BankNoteOption	mNoteOptions[kBankStepCount][kBankNoteOptionCount];
+};
+
+struct BankHeader
+{
+	char			mMagic[4];
+	uint16_t	mVersion;
+	uint16_t	mHeaderSize;
+
+	uint32_t	mPatternCount;
+	uint16_t	mStepCount;
+	uint16_t	mNoteOptionCount;
+	uint32_t	mPatternSize;
+
+	// from the start of the file
+	uint32_t	mChecksumOffset;
+	uint32_t	mPatternOffset;
+
+	// of the checksum table
+	uint32_t	mTableChecksum;
+
+	// of everything above
+	uint32_t	mHeaderChecksum;
+
+	uint8_t		mReserved[28];
+};
+
+static_assert(sizeof(BankNoteOption) == 32, "bank note option layout changed");
+static_assert(sizeof(BankHeader) == 64, "bank header layout changed");
+
+// CLASS
+
+class PatternBank
+{
+	public:
+
+		static const uint16_t	kVersion = 1;
+
+		PatternBank()
+			:
+			mHeader(nullptr),
+			mChecksums(nullptr),
+			mPatterns(nullptr)
+		{
+		}
+
+		// maps the file and checks the header and checksum table
+		// the patterns themselves are only checked by GetPattern()
+		bool
+		Open(const char *inPath);
+
+		uint32_t
+		GetPatternCount() const
+		{
+			return mHeader ? mHeader->mPatternCount : 0;
+		}
+
+		// null if it's out of range or its checksum is wrong
+		const BankPattern *
+		GetPattern(uint32_t inPatternNumber) const;
+
+		// checks every pattern, which touches the whole file
+		bool
+		Verify() const;
+
+		// every pattern, or false if any of them is damaged
+		bool
+		LoadAll(std::vector<Sequence> &outSequences) const;
+
+		// replaces the file whole, never rewrites it in place
+		static bool
+		Write(const char *inPath, const std::vector<Sequence> &inSequences);
+
+		static void
+		Load(const BankPattern &inPattern, Sequence &outSequence);
+
+		static void
+		Store(const Sequence &inSequence, BankPattern &outPattern);
+
+		// FNV-1a
+		static uint32_t
+		Checksum(const void *inData, size_t inLength)
+		{
+			const Byte	*data = (const Byte *) inData;
+			uint32_t		checksum = 2166136261u;
+
+			for (size_t i = 0; i < inLength; i++)
+				checksum = (checksum ^ data[i]) * 16777619u;
+
+			return checksum;
+		}
+
+	private:
+
+		MappedFile				mFile;
+
+		const BankHeader	*mHeader;
+		const uint32_t		*mChecksums;
+		const BankPattern	*mPatterns;
+};
+
+#endif	// PatternBank_h
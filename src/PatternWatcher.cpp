@@ -0,0 +1,192 @@
+// PatternWatcher.cpp
+
+// INCLUDES
+
+#include "PatternWatcher.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+#include <vector>
+
+#include "Modulation.h"
+#include "PatternBank.h"
+#include "Sequence.h"
+#include "Sequencer.h"
+
+PatternWatcher::PatternWatcher(Sequencer *inSequencer, const char *inPath, const Modulation *inModulation)
+	:
+	mSequencer(inSequencer),
+	mPath(inPath),
+	mModulation(inModulation),
+	mQueue(dispatch_queue_create("patternwatcher", 0)),
+	mWatchedFile(nullptr),
+	mRetry(nullptr),
+	mStopped(true)
+{
+}
+
+// a retry still waiting on the queue finds it's been let go of and does nothing
+PatternWatcher::~PatternWatcher()
+{
+	Stop();
+
+	dispatch_release(mQueue);
+}
+
+void
+PatternWatcher::Start()
+{
+	dispatch_sync_f(mQueue, this, StartProc);
+}
+
+void
+PatternWatcher::Stop()
+{
+	dispatch_sync_f(mQueue, this, StopProc);
+}
+
+void
+PatternWatcher::StartProc(void *inContext)
+{
+	PatternWatcher	*self = (PatternWatcher *) inContext;
+
+	self->mStopped = false;
+	self->Watch();
+}
+
+void
+PatternWatcher::StopProc(void *inContext)
+{
+	PatternWatcher	*self = (PatternWatcher *) inContext;
+
+	self->mStopped = true;
+
+	if (self->mWatchedFile)
+	{
+		dispatch_source_cancel(self->mWatchedFile->mSource);
+		self->mWatchedFile = nullptr;
+	}
+
+	if (self->mRetry)
+	{
+		self->mRetry->mWatcher = nullptr;
+		self->mRetry = nullptr;
+	}
+}
+
+void
+PatternWatcher::RetryProc(void *inContext)
+{
+	Retry						*retry = (Retry *) inContext;
+	PatternWatcher	*self = retry->mWatcher;
+
+	delete retry;
+
+	// stopped since, and maybe gone
+	if (self == nullptr)
+		return;
+
+	self->mRetry = nullptr;
+
+	if (self->mWatchedFile == nullptr)
+		self->Watch();
+}
+
+void
+PatternWatcher::EventProc(void *inContext)
+{
+	WatchedFile		*watchedFile = (WatchedFile *) inContext;
+	PatternWatcher	*self = watchedFile->mWatcher;
+
+	if (self->mStopped || watchedFile != self->mWatchedFile)
+		return;
+
+	unsigned long	flags = dispatch_source_get_data(watchedFile->mSource);
+
+	if (flags & (DISPATCH_VNODE_DELETE | DISPATCH_VNODE_RENAME))
+	{
+		// the name now means a different file, if any
+		dispatch_source_cancel(watchedFile->mSource);
+		self->mWatchedFile = nullptr;
+
+		self->Watch();
+	}
+	else
+	{
+		self->Reload();
+	}
+}
+
+void
+PatternWatcher::CancelProc(void *inContext)
+{
+	WatchedFile	*watchedFile = (WatchedFile *) inContext;
+
+	close(watchedFile->mFile);
+	dispatch_release(watchedFile->mSource);
+
+	delete watchedFile;
+}
+
+void
+PatternWatcher::Watch()
+{
+	if (mStopped)
+		return;
+
+	int	file = open(mPath, O_EVTONLY);
+
+	if (file < 0)
+	{
+		// mid save probably, try again shortly
+		if (mRetry == nullptr)
+		{
+			mRetry = new Retry;
+			mRetry->mWatcher = this;
+
+			dispatch_after_f(dispatch_time(DISPATCH_TIME_NOW, 250 * NSEC_PER_MSEC), mQueue, mRetry, RetryProc);
+		}
+
+		return;
+	}
+
+	WatchedFile	*watchedFile = new WatchedFile;
+
+	watchedFile->mWatcher = this;
+	watchedFile->mFile = file;
+	watchedFile->mSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_VNODE, file,
+		DISPATCH_VNODE_WRITE | DISPATCH_VNODE_EXTEND | DISPATCH_VNODE_DELETE | DISPATCH_VNODE_RENAME,
+		mQueue);
+
+	dispatch_set_context(watchedFile->mSource, watchedFile);
+	dispatch_source_set_event_handler_f(watchedFile->mSource, EventProc);
+	dispatch_source_set_cancel_handler_f(watchedFile->mSource, CancelProc);
+	dispatch_resume(watchedFile->mSource);
+
+	mWatchedFile = watchedFile;
+
+	// whatever is there now might be newer than what's playing
+	Reload();
+}
+
+void
+PatternWatcher::Reload()
+{
+	PatternBank	bank;
+
+	std::unique_ptr<std::vector<Sequence> >	sequences(new std::vector<Sequence>);
+
+	// a half written file fails its checksums and gets another go on the next write
+	if (!bank.Open(mPath) || !bank.LoadAll(*sequences) || sequences->size() == 0
+		|| !mModulation->Apply(*sequences))
+	{
+		fprintf(stderr, "could not reload %s, carrying on as before\n", mPath);
+		return;
+	}
+
+	printf("reloaded %u patterns from %s\n", (uint32_t) sequences->size(), mPath);
+
+	mSequencer->PublishSequences(sequences.release());
+}
@@ -0,0 +1,87 @@
+// PatternWatcher.h
+
+// GUARD
+
+#ifndef PatternWatcher_h
+#define PatternWatcher_h
+
+// INCLUDES
+
+#include <dispatch/dispatch.h>
+
+// FORWARD DECLARATIONS
+
+class Modulation;
+class Sequencer;
+
+// CLASS
+
+// reloads a pattern bank whenever its file changes and publishes it to the sequencer
+// with the same Modulation on it as when it was first loaded
+// everything happens on a serial dispatch queue, well away from the tick
+// a file that doesn't load is reported and otherwise ignored
+// editors that save by renaming get the new file watched once it turns up
+
+class PatternWatcher
+{
+	public:
+
+		PatternWatcher(Sequencer *inSequencer, const char *inPath, const Modulation *inModulation);
+
+		~PatternWatcher();
+
+		void
+		Start();
+
+		void
+		Stop();
+
+	private:
+
+		// one per watched file descriptor
+		struct WatchedFile
+		{
+			PatternWatcher		*mWatcher;
+			dispatch_source_t	mSource;
+			int								mFile;
+		};
+
+		// one per retry waiting on the queue, which Stop() can't take back
+		// so it lets go of the watcher instead
+		struct Retry
+		{
+			PatternWatcher		*mWatcher;
+		};
+
+		static void
+		StartProc(void *inContext);
+
+		static void
+		StopProc(void *inContext);
+
+		static void
+		RetryProc(void *inContext);
+
+		static void
+		EventProc(void *inContext);
+
+		static void
+		CancelProc(void *inContext);
+
+		void
+		Watch();
+
+		void
+		Reload();
+
+		Sequencer					*mSequencer;
+		const char				*mPath;
+		const Modulation	*mModulation;
+
+		dispatch_queue_t	mQueue;
+		WatchedFile				*mWatchedFile;
+		Retry							*mRetry;
+		bool							mStopped;
+};
+
+#endif	// PatternWatcher_h
@@ -0,0 +1,185 @@
+// PortOutput.h
+
+// GUARD
+
+#ifndef PortOutput_h
+#define PortOutput_h
+
+// INCLUDES
+
+#include <vector>
+
+#include "MIDICLOutputPort.h"
+#include "MIDICLPacketListBuilder.h"
+
+#include "HostTime.h"
+#include "NoteTable.h"
+#include "SequencerOutput.h"
+
+// CLASS
+
+// notes go to one port, clock and transport to any number
+// a tick's notes are held back and go out together in one packet
+// so a chord leaves in one burst rather than smeared over separate sends
+class PortOutput
+	:
+	public SequencerOutput
+{
+	public:
+
+		PortOutput(MIDICLOutputPort *inOutputPort,
+			const std::vector<MIDICLOutputPort *> &inClockPorts = std::vector<MIDICLOutputPort *>())
+			:
+			mOutputPort(inOutputPort),
+			mClockPorts(inClockPorts),
+			mTimeStamp(0),
+			mLength(0),
+			mBuilder(inOutputPort)
+		{
+		}
+
+		// whether it goes to these ports, so a caller can keep it
+		bool
+		SendsTo(MIDICLOutputPort *inOutputPort, const std::vector<MIDICLOutputPort *> &inClockPorts) const
+		{
+			return inOutputPort == mOutputPort && inClockPorts == mClockPorts;
+		}
+
+		void
+		SendNoteOn(Byte inChannel, Byte inKey, Byte inVelocity)
+		{
+			if (inVelocity == 0)
+				mNoteTable.NoteOff(inChannel, inKey);
+			else
+				mNoteTable.NoteOn(inChannel, inKey);
+
+			Add(0x90 | (inChannel & 0xf), inKey, inVelocity);
+		}
+
+		void
+		SendNoteOff(Byte inChannel, Byte inKey, Byte inVelocity)
+		{
+			mNoteTable.NoteOff(inChannel, inKey);
+
+			Add(0x80 | (inChannel & 0xf), inKey, inVelocity);
+		}
+
+		void
+		SendControlChange(Byte inChannel, Byte inController, Byte inValue)
+		{
+			Add(0xb0 | (inChannel & 0xf), inController, inValue);
+		}
+
+		void
+		SendPitchBend(Byte inChannel, uint16_t inValue)
+		{
+			Add(0xe0 | (inChannel & 0xf), inValue & 0x7f, inValue >> 7);
+		}
+
+		void
+		Tick()
+		{
+			Flush();
+		}
+
+		// with anything held back, all in the one packet
+		void
+		StopSounding()
+		{
+			if (mLength > sizeof(mBytes) - NoteTable::kMaximumNoteOffBytes)
+				Flush();
+
+			mLength += mNoteTable.TakeNoteOffs(mBytes + mLength);
+
+			Flush();
+		}
+
+		void
+		SetTime(uint64_t inTime)
+		{
+			// what's held back was meant for the old time
+			Flush();
+
+			// stamped on each send rather than set on the ports, which other senders share
+			mTimeStamp = inTime ? HostTime::FromNanoseconds(inTime) : 0;
+		}
+
+		void
+		SendClock()
+		{
+			for (MIDICLOutputPort *clockPort : mClockPorts)
+				clockPort->SendClock(mTimeStamp);
+		}
+
+		void
+		SendStart()
+		{
+			for (MIDICLOutputPort *clockPort : mClockPorts)
+				clockPort->SendStart(mTimeStamp);
+		}
+
+		void
+		SendContinue()
+		{
+			for (MIDICLOutputPort *clockPort : mClockPorts)
+				clockPort->SendContinue(mTimeStamp);
+		}
+
+		void
+		SendStop()
+		{
+			for (MIDICLOutputPort *clockPort : mClockPorts)
+				clockPort->SendStop(mTimeStamp);
+		}
+
+		void
+		SendSongPosition(uint32_t inPosition)
+		{
+			for (MIDICLOutputPort *clockPort : mClockPorts)
+				clockPort->SendSongPosition(inPosition, mTimeStamp);
+		}
+
+	private:
+
+		// room for every note off and a busy tick's worth besides
+		static const uint32_t	kMaximumBytes = NoteTable::kMaximumNoteOffBytes * 2;
+
+		void
+		Add(Byte inStatus, Byte inOne, Byte inTwo)
+		{
+			if (mLength + 3 > sizeof(mBytes))
+				Flush();
+
+			mBytes[mLength++] = inStatus;
+			mBytes[mLength++] = inOne & 0x7f;
+			mBytes[mLength++] = inTwo & 0x7f;
+		}
+
+		void
+		Flush()
+		{
+			if (mLength == 0)
+				return;
+
+			mBuilder.Add(mTimeStamp, mBytes, mLength);
+			mBuilder.Flush();
+
+			mLength = 0;
+		}
+
+		MIDICLOutputPort	*mOutputPort;
+
+		std::vector<MIDICLOutputPort *>	mClockPorts;
+
+		MIDITimeStamp			mTimeStamp;
+
+		NoteTable					mNoteTable;
+
+		// held back until the end of the tick
+		Byte							mBytes[kMaximumBytes];
+		uint32_t					mLength;
+
+		MIDICLPacketListBuilder	mBuilder;
+};
+
+#endif	// PortOutput_h
@@ -0,0 +1,65 @@
+// Random.h
+
+// GUARD
+
+#ifndef Random_h
+#define Random_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+// CLASS
+
+// xorshift64* seeded through splitmix64
+// each sequencer has its own, so variations are repeatable per seed
+// and renders can run side by side without sharing state
+
+class Random
+{
+	public:
+
+		Random(uint64_t inSeed = 1)
+		{
+			Seed(inSeed);
+		}
+
+		void
+		Seed(uint64_t inSeed)
+		{
+			// splitmix so that neighbouring seeds start far apart
+			uint64_t	z = inSeed + 0x9e3779b97f4a7c15ULL;
+
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+			mState = z ^ (z >> 31);
+
+			// xorshift never leaves zero
+			if (mState == 0)
+				mState = 1;
+		}
+
+		uint32_t
+		Next()
+		{
+			mState ^= mState >> 12;
+			mState ^= mState << 25;
+			mState ^= mState >> 27;
+
+			return (uint32_t) ((mState * 0x2545f4914f6cdd1dULL) >> 32);
+		}
+
+		// 0..inRange-1
+		uint32_t
+		Below(uint32_t inRange)
+		{
+			return (uint32_t) (((uint64_t) Next() * inRange) >> 32);
+		}
+
+	private:
+
+		uint64_t	mState;
+};
+
+#endif	// Random_h
@@ -0,0 +1,22 @@
+// RatchetTable.cpp
+
+// INCLUDES
+
+#include "RatchetTable.h"
+
+#include <math.h>
+
+RatchetTable::RatchetTable()
+{
+	for (uint32_t spacing = 0; spacing <= kMaximumSpacing; spacing++)
+	{
+		for (uint32_t hit = 0; hit < kMaximumCount; hit++)
+			mOffsets[spacing][hit] = (spacing > 0 ? spacing : 1) * hit;
+	}
+
+	for (uint32_t decay = 0; decay <= kMaximumDecay; decay++)
+	{
+		for (uint32_t hit = 0; hit < kMaximumCount; hit++)
+			mGains[decay][hit] = (uint16_t) lround(256.0 * pow((100 - decay) / 100.0, hit));
+	}
+}
@@ -0,0 +1,55 @@
+// RatchetTable.h
+
+// GUARD
+
+#ifndef RatchetTable_h
+#define RatchetTable_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+// CLASS
+
+// where each hit of a ratchet lands and how hard, for every spacing and decay
+// worked out once, so a step that ratchets just copies its hits into the wheel
+
+class RatchetTable
+{
+	public:
+
+		static const uint32_t	kMaximumCount = 16;
+		static const uint32_t	kMaximumSpacing = 24;
+		static const uint32_t	kMaximumDecay = 100;
+
+		static const RatchetTable &
+		Get()
+		{
+			static RatchetTable	sTable;
+
+			return sTable;
+		}
+
+		// ticks from the start of the step to each hit
+		const uint16_t *
+		GetOffsets(uint32_t inSpacing) const
+		{
+			return mOffsets[inSpacing < kMaximumSpacing ? inSpacing : kMaximumSpacing];
+		}
+
+		// how hard each hit is, out of 256
+		const uint16_t *
+		GetGains(uint32_t inDecay) const
+		{
+			return mGains[inDecay < kMaximumDecay ? inDecay : kMaximumDecay];
+		}
+
+	private:
+
+		RatchetTable();
+
+		uint16_t	mOffsets[kMaximumSpacing + 1][kMaximumCount];
+		uint16_t	mGains[kMaximumDecay + 1][kMaximumCount];
+};
+
+#endif	// RatchetTable_h
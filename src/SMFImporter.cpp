@@ -0,0 +1,244 @@
+// SMFImporter.cpp
+
+// INCLUDES
+
+#include "SMFImporter.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "MappedFile.h"
+#include "SMFReader.h"
+#include "Sequence.h"
+#include "Utility.h"
+
+SMFImporter::SMFImporter()
+{
+	Reset();
+}
+
+void
+SMFImporter::Reset()
+{
+	memset(mSteps, 0, sizeof(mSteps));
+
+	for (std::vector<bool> &takesHit : mTakesHit)
+		takesHit.clear();
+
+	mTakeCount = 0;
+	mEventCount = 0;
+	mByteCount = 0;
+}
+
+bool
+SMFImporter::Import(const char *inPath)
+{
+	MappedFile	file;
+
+	if (!file.Open(inPath))
+		return false;
+
+	SMFReader	reader(file.GetData(), file.GetLength());
+
+	if (!reader.ReadHeader())
+		return false;
+
+	// read into a scratch copy so a bad file leaves nothing behind
+	std::unique_ptr<SMFImporter>	scratch(new SMFImporter);
+
+	scratch->mStepTicks = std::max(1, reader.GetDivision() / 2);
+
+	memset(scratch->mPendingNotes, 0, sizeof(scratch->mPendingNotes));
+
+	const Byte	*track = nullptr;
+	const Byte	*trackEnd = nullptr;
+
+	while (reader.NextTrack(track, trackEnd))
+	{
+		if (!SMFReader::ReadTrack(track, trackEnd, *scratch))
+			return false;
+	}
+
+	// as many takes as reach the last note, each counted once on each step it hit
+	scratch->mTakeCount = 1;
+
+	for (uint32_t stepNumber = 0; stepNumber < kStepCount; stepNumber++)
+	{
+		const std::vector<bool>	&takesHit(scratch->mTakesHit[stepNumber]);
+
+		scratch->mSteps[stepNumber].mHitTakes = std::count(takesHit.begin(), takesHit.end(), true);
+		scratch->mTakeCount = std::max(scratch->mTakeCount, (uint32_t) takesHit.size());
+	}
+
+	scratch->mByteCount = file.GetLength();
+
+	Merge(*scratch);
+
+	return true;
+}
+
+void
+SMFImporter::Merge(const SMFImporter &inOther)
+{
+	for (uint32_t stepNumber = 0; stepNumber < kStepCount; stepNumber++)
+	{
+		for (uint32_t note = 0; note < 128; note++)
+		{
+			const NoteStats	&stats(inOther.mSteps[stepNumber].mNotes[note]);
+
+			if (stats.mCount)
+			{
+				AddNote(mSteps[stepNumber].mNotes[note], stats.mCount,
+					stats.mVelocityLower, stats.mVelocityUpper,
+					stats.mGateTimeLower, stats.mGateTimeUpper);
+			}
+		}
+	}
+
+	for (uint32_t stepNumber = 0; stepNumber < kStepCount; stepNumber++)
+		mSteps[stepNumber].mHitTakes += inOther.mSteps[stepNumber].mHitTakes;
+
+	mTakeCount += inOther.mTakeCount;
+	mEventCount += inOther.mEventCount;
+	mByteCount += inOther.mByteCount;
+}
+
+void
+SMFImporter::ChannelMessage(uint32_t inTick, Byte inStatus, Byte inOne, Byte inTwo)
+{
+	mEventCount++;
+
+	Byte	type = inStatus & 0xf0;
+	Byte	channel = inStatus & 0x0f;
+	Byte	note = inOne & 0x7f;
+
+	PendingNote	&pending(mPendingNotes[channel][note]);
+
+	if (type == 0x90 && inTwo > 0)
+	{
+		pending.mTick = inTick;
+		pending.mVelocity = inTwo;
+		pending.mSounding = true;
+	}
+	else if ((type == 0x80 || type == 0x90) && pending.mSounding)
+	{
+		pending.mSounding = false;
+
+		// nearest step, and its place in the loop
+		uint32_t	step = (pending.mTick + mStepTicks / 2) / mStepTicks;
+		uint32_t	take = step / kStepCount;
+		uint32_t	gateTime = (inTick - pending.mTick) * 100 / mStepTicks;
+
+		int16_t	gate = (int16_t) std::max(1u, std::min((uint32_t) INT16_MAX, gateTime));
+
+		StepStats	&stats(mSteps[step % kStepCount]);
+
+		AddNote(stats.mNotes[note], 1, pending.mVelocity, pending.mVelocity, gate, gate);
+
+		std::vector<bool>	&takesHit(mTakesHit[step % kStepCount]);
+
+		if (take >= takesHit.size())
+			takesHit.resize(take + 1);
+
+		takesHit[take] = true;
+	}
+}
+
+void
+SMFImporter::AddNote(NoteStats &ioStats, uint32_t inCount,
+	uint8_t inVelocityLower, uint8_t inVelocityUpper,
+	int16_t inGateTimeLower, int16_t inGateTimeUpper)
+{
+	if (ioStats.mCount == 0)
+	{
+		ioStats.mVelocityLower = inVelocityLower;
+		ioStats.mVelocityUpper = inVelocityUpper;
+		ioStats.mGateTimeLower = inGateTimeLower;
+		ioStats.mGateTimeUpper = inGateTimeUpper;
+	}
+	else
+	{
+		ioStats.mVelocityLower = std::min(ioStats.mVelocityLower, inVelocityLower);
+		ioStats.mVelocityUpper = std::max(ioStats.mVelocityUpper, inVelocityUpper);
+		ioStats.mGateTimeLower = std::min(ioStats.mGateTimeLower, inGateTimeLower);
+		ioStats.mGateTimeUpper = std::max(ioStats.mGateTimeUpper, inGateTimeUpper);
+	}
+
+	ioStats.mCount += inCount;
+}
+
+void
+SMFImporter::MakeSequence(Sequence &outSequence) const
+{
+	for (uint32_t stepNumber = 0; stepNumber < outSequence.GetStepCount(); stepNumber++)
+	{
+		const StepStats	&stats(mSteps[stepNumber % kStepCount]);
+
+		// the most common note on this step
+		uint32_t	commonNote = 0;
+
+		for (uint32_t note = 1; note < 128; note++)
+		{
+			if (stats.mNotes[note].mCount > stats.mNotes[commonNote].mCount)
+				commonNote = note;
+		}
+
+		// and the rest lumped together
+		NoteStats	others;
+		uint8_t		noteLower = 127;
+		uint8_t		noteUpper = 0;
+
+		memset(&others, 0, sizeof(others));
+
+		for (uint32_t note = 0; note < 128; note++)
+		{
+			const NoteStats	&noteStats(stats.mNotes[note]);
+
+			if (note != commonNote && noteStats.mCount)
+			{
+				AddNote(others, noteStats.mCount,
+					noteStats.mVelocityLower, noteStats.mVelocityUpper,
+					noteStats.mGateTimeLower, noteStats.mGateTimeUpper);
+
+				noteLower = std::min(noteLower, (uint8_t) note);
+				noteUpper = std::max(noteUpper, (uint8_t) note);
+			}
+		}
+
+		const NoteStats	&common(stats.mNotes[commonNote]);
+
+		// the chance of anything here, shared out by note count
+		uint32_t	noteCount = std::max(1u, common.mCount + others.mCount);
+		uint32_t	probability = stats.mHitTakes * 100 / std::max(1u, mTakeCount);
+
+		NoteOption	&first(outSequence.GetStep(stepNumber).GetNoteOption(0));
+		NoteOption	&second(outSequence.GetStep(stepNumber).GetNoteOption(1));
+
+		first = NoteOption();
+		first.mProbability = probability * common.mCount / noteCount;
+
+		if (common.mCount)
+		{
+			first.mNoteLower = first.mNoteUpper = commonNote;
+			first.mVelocityLower = common.mVelocityLower;
+			first.mVelocityUpper = common.mVelocityUpper;
+			first.mGateTimeLower = common.mGateTimeLower;
+			first.mGateTimeUpper = common.mGateTimeUpper;
+		}
+
+		second = NoteOption();
+		second.mProbability = probability - first.mProbability;
+
+		if (others.mCount)
+		{
+			second.mNoteLower = noteLower;
+			second.mNoteUpper = noteUpper;
+			second.mVelocityLower = others.mVelocityLower;
+			second.mVelocityUpper = others.mVelocityUpper;
+			second.mGateTimeLower = others.mGateTimeLower;
+			second.mGateTimeUpper = others.mGateTimeUpper;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+// SMFImporter.h
+
+// GUARD
+
+#ifndef SMFImporter_h
+#define SMFImporter_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <CoreMIDI/MIDIServices.h>
+
+// FORWARD DECLARATIONS
+
+class Sequence;
+
+// CLASS
+
+// collects notes from any number of takes, quantised to quaver steps
+// every loop's worth of a file is another take of the pattern
+// MakeSequence() turns the most common note on each step into option 0
+// and everything else on that step into option 1, with ranges to match
+
+class SMFImporter
+{
+	public:
+
+		SMFImporter();
+
+		void
+		Reset();
+
+		// false if the file couldn't be read, nothing is kept from it
+		bool
+		Import(const char *inPath);
+
+		void
+		Merge(const SMFImporter &inOther);
+
+		void
+		MakeSequence(Sequence &outSequence) const;
+
+		uint64_t
+		GetEventCount() const
+		{
+			return mEventCount;
+		}
+
+		uint64_t
+		GetByteCount() const
+		{
+			return mByteCount;
+		}
+
+		// SMFReader handler
+		void
+		ChannelMessage(uint32_t inTick, Byte inStatus, Byte inOne, Byte inTwo);
+
+	private:
+
+		struct NoteStats
+		{
+			uint32_t	mCount;
+
+			uint8_t		mVelocityLower;
+			uint8_t		mVelocityUpper;
+
+			// percent of step length
+			int16_t		mGateTimeLower;
+			int16_t		mGateTimeUpper;
+		};
+
+		struct StepStats
+		{
+			NoteStats	mNotes[128];
+
+			// takes with anything at all on this step
+			uint32_t	mHitTakes;
+		};
+
+		// a note waiting for its note off
+		struct PendingNote
+		{
+			uint32_t	mTick;
+			uint8_t		mVelocity;
+			bool			mSounding;
+		};
+
+		static void
+		AddNote(NoteStats &ioStats, uint32_t inCount,
+			uint8_t inVelocityLower, uint8_t inVelocityUpper,
+			int16_t inGateTimeLower, int16_t inGateTimeUpper);
+
+		static const uint32_t	kStepCount = 16;
+
+		StepStats		mSteps[kStepCount];
+
+		uint32_t		mTakeCount;
+
+		// per file
+		uint32_t		mStepTicks;
+		PendingNote	mPendingNotes[16][128];
+
+		// a bit per take for each step, set by anything on it from any track
+		// so chords, ratchets and tracks that play together only count once
+		std::vector<bool>	mTakesHit[kStepCount];
+
+		uint64_t		mEventCount;
+		uint64_t		mByteCount;
+};
+
+#endif	// SMFImporter_h
@@ -0,0 +1,59 @@
+// SMFReader.cpp
+
+// INCLUDES
+
+#include "SMFReader.h"
+
+#include <string.h>
+
+const Byte	SMFReader::kDataLengths[8] = { 2, 2, 2, 2, 1, 1, 2, 0 };
+
+bool
+SMFReader::ReadHeader()
+{
+	if (mEnd - mData < 14 || memcmp(mData, "MThd", 4) != 0)
+		return false;
+
+	uint32_t	length = ReadUInt32(mData + 4);
+
+	if (length < 6 || length > (size_t) (mEnd - mData) - 8)
+		return false;
+
+	mFormat = (mData[8] << 8) | mData[9];
+	mTrackCount = (mData[10] << 8) | mData[11];
+	mDivision = (mData[12] << 8) | mData[13];
+
+	// SMPTE divisions don't quantise to steps
+	if (mDivision == 0 || (mDivision & 0x8000))
+		return false;
+
+	mNext = mData + 8 + length;
+
+	return true;
+}
+
+bool
+SMFReader::NextTrack(const Byte *&outTrack, const Byte *&outEnd)
+{
+	while (mEnd - mNext >= 8)
+	{
+		uint32_t	length = ReadUInt32(mNext + 4);
+		const Byte	*chunk = mNext + 8;
+
+		// be kind to a truncated last track
+		if (length > (size_t) (mEnd - chunk))
+			length = mEnd - chunk;
+
+		mNext = chunk + length;
+
+		if (memcmp(chunk - 8, "MTrk", 4) == 0)
+		{
+			outTrack = chunk;
+			outEnd = chunk + length;
+
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,191 @@
+// SMFReader.h
+
+// GUARD
+
+#ifndef SMFReader_h
+#define SMFReader_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// walks chunks and events in place, nothing is copied or allocated
+// channel messages go to the handler, meta and sysex events are skipped
+
+class SMFReader
+{
+	public:
+
+		SMFReader(const Byte *inData, size_t inLength)
+			:
+			mData(inData),
+			mEnd(inData + inLength),
+			mNext(inData),
+			mFormat(0),
+			mTrackCount(0),
+			mDivision(0)
+		{
+		}
+
+		// false if it isn't a file we can read
+		bool
+		ReadHeader();
+
+		// the next MTrk chunk, skipping any others
+		bool
+		NextTrack(const Byte *&outTrack, const Byte *&outEnd);
+
+		// the handler gets ChannelMessage(tick, status, one, two)
+		// false if the track is damaged
+		template<typename H> static bool
+		ReadTrack(const Byte *inTrack, const Byte *inEnd, H &inHandler);
+
+		uint16_t
+		GetFormat() const
+		{
+			return mFormat;
+		}
+
+		uint16_t
+		GetTrackCount() const
+		{
+			return mTrackCount;
+		}
+
+		// ticks per quarter note
+		uint16_t
+		GetDivision() const
+		{
+			return mDivision;
+		}
+
+	private:
+
+		static bool
+		ReadVariableLength(const Byte *&ioData, const Byte *inEnd, uint32_t &outValue)
+		{
+			outValue = 0;
+
+			// at most four bytes
+			for (int count = 0; count < 4 && ioData < inEnd; count++)
+			{
+				Byte	byte = *ioData++;
+
+				outValue = (outValue << 7) | (byte & 0x7f);
+
+				if ((byte & 0x80) == 0)
+					return true;
+			}
+
+			return false;
+		}
+
+		static uint32_t
+		ReadUInt32(const Byte *inData)
+		{
+			return ((uint32_t) inData[0] << 24) | ((uint32_t) inData[1] << 16) | ((uint32_t) inData[2] << 8) | inData[3];
+		}
+
+		// data bytes for 0x80..0xe0
+		static const Byte	kDataLengths[8];
+
+		const Byte	*mData;
+		const Byte	*mEnd;
+		const Byte	*mNext;
+
+		uint16_t		mFormat;
+		uint16_t		mTrackCount;
+		uint16_t		mDivision;
+};
+
+template<typename H> bool
+SMFReader::ReadTrack(const Byte *inTrack, const Byte *inEnd, H &inHandler)
+{
+	const Byte	*data = inTrack;
+	uint32_t		tick = 0;
+	Byte				status = 0;
+
+	while (data < inEnd)
+	{
+		uint32_t	delta = 0;
+
+		if (!ReadVariableLength(data, inEnd, delta) || data >= inEnd)
+			return false;
+
+		tick += delta;
+
+		if (*data == 0xff)
+		{
+			// meta event
+			uint32_t	length = 0;
+
+			if (inEnd - data < 2)
+				return false;
+
+			Byte	type = data[1];
+
+			data += 2;
+
+			if (!ReadVariableLength(data, inEnd, length) || length > (size_t) (inEnd - data))
+				return false;
+
+			data += length;
+
+			// meta and sysex events cancel running status
+			status = 0;
+
+			// end of track
+			if (type == 0x2f)
+				break;
+
+			continue;
+		}
+
+		if (*data == 0xf0 || *data == 0xf7)
+		{
+			// sysex or escape, skip the lot
+			uint32_t	length = 0;
+
+			data++;
+
+			if (!ReadVariableLength(data, inEnd, length) || length > (size_t) (inEnd - data))
+				return false;
+
+			data += length;
+			status = 0;
+
+			continue;
+		}
+
+		if (*data & 0x80)
+		{
+			status = *data++;
+		}
+		else if (status == 0)
+		{
+			// data byte with no running status
+			return false;
+		}
+
+		// other system messages don't belong in files
+		if (status >= 0xf0)
+			return false;
+
+		Byte	dataLength = kDataLengths[(status >> 4) & 7];
+
+		if (inEnd - data < dataLength)
+			return false;
+
+		inHandler.ChannelMessage(tick, status, data[0], dataLength > 1 ? data[1] : 0);
+
+		data += dataLength;
+	}
+
+	return true;
+}
+
+#endif	// SMFReader_h
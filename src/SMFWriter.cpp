@@ -0,0 +1,262 @@
+// SMFWriter.cpp
+
+// INCLUDES
+
+#include "SMFWriter.h"
+
+#include <string.h>
+
+SMFWriter::SMFWriter()
+	:
+	mFile(nullptr),
+	mTracks(nullptr),
+	mError(false),
+	mFormat(1),
+	mTrackCount(0),
+	mMicrosecondsPerQuarter(500000),
+	mOffset(0),
+	mTrackLengthOffset(0),
+	mTrackStartOffset(0),
+	mDeltaTicks(0),
+	mRunningStatus(0),
+	mEventCount(0),
+	mBufferLength(0)
+{
+}
+
+SMFWriter::~SMFWriter()
+{
+	if (mFile || mTracks)
+		Close();
+}
+
+bool
+SMFWriter::Open(const char *inPath, uint16_t inFormat, uint32_t inMicrosecondsPerQuarter)
+{
+	mFile = fopen(inPath, "wb");
+
+	if (mFile == nullptr)
+		return false;
+
+	mError = false;
+	mFormat = inFormat;
+	mTrackCount = 0;
+	mMicrosecondsPerQuarter = inMicrosecondsPerQuarter;
+	mOffset = 0;
+	mEventCount = 0;
+	mBufferLength = 0;
+
+	// the track count gets patched in Close()
+	static const Byte	header[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6 };
+
+	WriteBytes(header, sizeof(header));
+	WriteUInt16(mFormat);
+	WriteUInt16(0);
+	WriteUInt16(24);
+
+	if (mFormat == 1)
+	{
+		BeginTrack(nullptr);
+		EndTrack();
+	}
+
+	return true;
+}
+
+void
+SMFWriter::OpenTracks(std::vector<Byte> *outTracks)
+{
+	mTracks = outTracks;
+	mTracks->clear();
+
+	mError = false;
+	mFormat = 1;
+	mTrackCount = 0;
+	mOffset = 0;
+	mEventCount = 0;
+	mBufferLength = 0;
+}
+
+bool
+SMFWriter::Close()
+{
+	if (mTracks)
+	{
+		Flush();
+		mTracks = nullptr;
+
+		return true;
+	}
+
+	if (mFile == nullptr)
+		return false;
+
+	Flush();
+
+	Byte	count[2] = { (Byte) (mTrackCount >> 8), (Byte) mTrackCount };
+
+	Patch(10, count, sizeof(count));
+
+	if (fclose(mFile) != 0)
+		mError = true;
+
+	mFile = nullptr;
+
+	return !mError;
+}
+
+void
+SMFWriter::BeginTrack(const char *inName)
+{
+	static const Byte	header[] = { 'M', 'T', 'r', 'k' };
+
+	WriteBytes(header, sizeof(header));
+
+	mTrackLengthOffset = mOffset + mBufferLength;
+	WriteUInt32(0);
+	mTrackStartOffset = mTrackLengthOffset + 4;
+
+	mDeltaTicks = 0;
+	mRunningStatus = 0;
+
+	if (inName)
+		WriteMeta(0x03, (const Byte *) inName, strlen(inName));
+
+	// format 0 carries the tempo in its only track
+	// format 1 carries it in track 0 which has no name
+	if (mFormat == 0 || inName == nullptr)
+	{
+		Byte	tempo[3] =
+		{
+			(Byte) (mMicrosecondsPerQuarter >> 16),
+			(Byte) (mMicrosecondsPerQuarter >> 8),
+			(Byte) mMicrosecondsPerQuarter
+		};
+
+		WriteMeta(0x51, tempo, sizeof(tempo));
+
+		// 4/4, 24 clocks per click, 8 32nds per quarter
+		static const Byte	timeSignature[] = { 4, 2, 24, 8 };
+
+		WriteMeta(0x58, timeSignature, sizeof(timeSignature));
+	}
+}
+
+void
+SMFWriter::EndTrack()
+{
+	WriteMeta(0x2f, nullptr, 0);
+	Flush();
+
+	uint32_t	length = mOffset - mTrackStartOffset;
+	Byte			bytes[4] = { (Byte) (length >> 24), (Byte) (length >> 16), (Byte) (length >> 8), (Byte) length };
+
+	Patch(mTrackLengthOffset, bytes, sizeof(bytes));
+
+	mTrackCount++;
+}
+
+void
+SMFWriter::AppendTrack(const Byte *inTrack, uint32_t inLength)
+{
+	WriteBytes(inTrack, inLength);
+
+	mTrackCount++;
+}
+
+void
+SMFWriter::WriteMeta(Byte inType, const Byte *inData, uint32_t inLength)
+{
+	if (mBufferLength + 16 > sizeof(mBuffer))
+		Flush();
+
+	WriteDelta();
+
+	mBuffer[mBufferLength++] = 0xff;
+	mBuffer[mBufferLength++] = inType;
+
+	WriteVariableLength(inLength);
+
+	WriteBytes(inData, inLength);
+
+	// meta events cancel running status
+	mRunningStatus = 0;
+}
+
+void
+SMFWriter::WriteBytes(const Byte *inData, uint32_t inLength)
+{
+	if (mBufferLength + inLength > sizeof(mBuffer))
+		Flush();
+
+	if (inLength > sizeof(mBuffer))
+	{
+		memcpy(mBuffer, inData, sizeof(mBuffer));
+		mBufferLength = sizeof(mBuffer);
+
+		Flush();
+		WriteBytes(inData + sizeof(mBuffer), inLength - sizeof(mBuffer));
+	}
+	else
+	{
+		memcpy(mBuffer + mBufferLength, inData, inLength);
+		mBufferLength += inLength;
+	}
+}
+
+void
+SMFWriter::WriteUInt16(uint16_t inValue)
+{
+	Byte	bytes[2] = { (Byte) (inValue >> 8), (Byte) inValue };
+
+	WriteBytes(bytes, sizeof(bytes));
+}
+
+void
+SMFWriter::WriteUInt32(uint32_t inValue)
+{
+	Byte	bytes[4] = { (Byte) (inValue >> 24), (Byte) (inValue >> 16), (Byte) (inValue >> 8), (Byte) inValue };
+
+	WriteBytes(bytes, sizeof(bytes));
+}
+
+// only for bytes that have already been flushed
+void
+SMFWriter::Patch(uint32_t inOffset, const Byte *inData, uint32_t inLength)
+{
+	if (mTracks)
+	{
+		memcpy(mTracks->data() + inOffset, inData, inLength);
+	}
+	else if (fseek(mFile, inOffset, SEEK_SET) == 0)
+	{
+		if (fwrite(inData, 1, inLength, mFile) != inLength)
+			mError = true;
+
+		if (fseek(mFile, mOffset, SEEK_SET) != 0)
+			mError = true;
+	}
+	else
+	{
+		mError = true;
+	}
+}
+
+void
+SMFWriter::Flush()
+{
+	if (mBufferLength > 0)
+	{
+		if (mTracks)
+		{
+			mTracks->insert(mTracks->end(), mBuffer, mBuffer + mBufferLength);
+		}
+		else if (fwrite(mBuffer, 1, mBufferLength, mFile) != mBufferLength)
+		{
+			mError = true;
+		}
+
+		mOffset += mBufferLength;
+		mBufferLength = 0;
+	}
+}
@@ -0,0 +1,185 @@
+// SMFWriter.h
+
+// GUARD
+
+#ifndef SMFWriter_h
+#define SMFWriter_h
+
+// INCLUDES
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <vector>
+
+#include "SequencerOutput.h"
+
+// CLASS
+
+// streams events to disk through one big buffer
+// delta times are counted in sequencer ticks, so division is 24ppqn
+// format 0 is a single track, format 1 puts the tempo in track 0
+// and gives every BeginTrack() its own track
+
+// OpenTracks() writes bare track chunks to memory instead
+// so that separately rendered tracks can be appended to one file
+
+class SMFWriter
+	:
+	public SequencerOutput
+{
+	public:
+
+		SMFWriter();
+
+		~SMFWriter();
+
+		bool
+		Open(const char *inPath, uint16_t inFormat, uint32_t inMicrosecondsPerQuarter);
+
+		// format 1 track chunks only, no header
+		void
+		OpenTracks(std::vector<Byte> *outTracks);
+
+		bool
+		Close();
+
+		void
+		BeginTrack(const char *inName);
+
+		void
+		EndTrack();
+
+		// a complete track chunk from an OpenTracks() writer
+		void
+		AppendTrack(const Byte *inTrack, uint32_t inLength);
+
+		void
+		SendNoteOn(Byte inChannel, Byte inKey, Byte inVelocity)
+		{
+			WriteEvent(0x90 | inChannel, inKey, inVelocity);
+		}
+
+		void
+		SendNoteOff(Byte inChannel, Byte inKey, Byte inVelocity)
+		{
+			WriteEvent(0x80 | inChannel, inKey, inVelocity);
+		}
+
+		void
+		SendControlChange(Byte inChannel, Byte inController, Byte inValue)
+		{
+			WriteEvent(0xb0 | inChannel, inController, inValue);
+		}
+
+		void
+		SendPitchBend(Byte inChannel, uint16_t inValue)
+		{
+			WriteEvent(0xe0 | inChannel, inValue & 0x7f, inValue >> 7);
+		}
+
+		void
+		Tick()
+		{
+			mDeltaTicks++;
+		}
+
+		uint64_t
+		GetEventCount() const
+		{
+			return mEventCount;
+		}
+
+	private:
+
+		void
+		WriteEvent(Byte inStatus, Byte inOne, Byte inTwo)
+		{
+			if (mBufferLength + 8 > sizeof(mBuffer))
+				Flush();
+
+			WriteDelta();
+
+			// running status, events in a track are mostly the same status
+			if (inStatus != mRunningStatus)
+			{
+				mBuffer[mBufferLength++] = inStatus;
+				mRunningStatus = inStatus;
+			}
+
+			mBuffer[mBufferLength++] = inOne;
+			mBuffer[mBufferLength++] = inTwo;
+
+			mEventCount++;
+		}
+
+		void
+		WriteDelta()
+		{
+			WriteVariableLength(mDeltaTicks);
+			mDeltaTicks = 0;
+		}
+
+		// caller makes sure there are 5 bytes free
+		void
+		WriteVariableLength(uint32_t inValue)
+		{
+			// most significant group first
+			Byte	bytes[5];
+			int		count = 0;
+
+			do
+			{
+				bytes[count++] = inValue & 0x7f;
+				inValue >>= 7;
+			}
+			while (inValue);
+
+			while (count > 1)
+				mBuffer[mBufferLength++] = bytes[--count] | 0x80;
+
+			mBuffer[mBufferLength++] = bytes[0];
+		}
+
+		void
+		WriteMeta(Byte inType, const Byte *inData, uint32_t inLength);
+
+		void
+		WriteBytes(const Byte *inData, uint32_t inLength);
+
+		void
+		WriteUInt16(uint16_t inValue);
+
+		void
+		WriteUInt32(uint32_t inValue);
+
+		void
+		Patch(uint32_t inOffset, const Byte *inData, uint32_t inLength);
+
+		void
+		Flush();
+
+		FILE							*mFile;
+		std::vector<Byte>	*mTracks;
+		bool							mError;
+
+		uint16_t	mFormat;
+		uint16_t	mTrackCount;
+		uint32_t	mMicrosecondsPerQuarter;
+
+		// bytes flushed so far
+		uint32_t	mOffset;
+
+		// offset of the current track's length field
+		uint32_t	mTrackLengthOffset;
+		uint32_t	mTrackStartOffset;
+
+		uint32_t	mDeltaTicks;
+		Byte			mRunningStatus;
+		uint64_t	mEventCount;
+
+		uint32_t	mBufferLength;
+		Byte			mBuffer[65536];
+};
+
+#endif	// SMFWriter_h
@@ -0,0 +1,41 @@
+// Sequence.cpp
+
+// INCLUDES
+
+#include "Sequence.h"
+
+void
+Sequence::SetUpDefault()
+{
+	for (uint32_t stepNumber = 0; stepNumber < GetStepCount(); stepNumber++)
+	{
+		Step	&step(GetStep(stepNumber));
+
+		step.GetNoteOption(0).mNoteLower = 40;
+		step.GetNoteOption(0).mNoteUpper = 60;
+		step.GetNoteOption(0).mGateTimeLower = 70;
+		step.GetNoteOption(0).mGateTimeUpper = 80;
+		step.GetNoteOption(0).mProbability = 90;
+	
+		step.GetNoteOption(1).mNoteLower = 50;
+		step.GetNoteOption(1).mNoteUpper = 50;
+		step.GetNoteOption(1).mProbability = 25;
+		step.GetNoteOption(1).mRatchetProbability = 100;
+	}
+}
+
+void
+Sequence::SelectNoteOption(uint32_t inStepNumber, Random &inRandom)
+{
+	if (mLFOs.GetCount() == 0)
+	{
+		GetStep(inStepNumber).SelectNoteOption(inRandom);
+		return;
+	}
+
+	int16_t	offsets[LFOBank::kTargetCount];
+
+	mLFOs.Advance(inRandom, offsets);
+
+	GetStep(inStepNumber).SelectNoteOption(inRandom, offsets);
+}
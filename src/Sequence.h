@@ -0,0 +1,103 @@
+// Sequence.h
+
+// GUARD
+
+#ifndef Sequence_h
+#define Sequence_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "AutomationLane.h"
+#include "LFOBank.h"
+#include "Random.h"
+#include "Step.h"
+
+// CLASS
+
+class Sequence
+{
+	public:
+	
+		Sequence()
+			:
+			mSteps(16)
+		{
+		}
+
+		NoteOption *
+		GetSelectedNoteOption(uint32_t inStepNumber)
+		{
+			return mSteps[inStepNumber].GetSelectedNoteOption();
+		}
+
+		// the built in pattern, for when there's nothing to import or load
+		void
+		SetUpDefault();
+
+		// this sets mSelectedOption in the step
+		// and moves the LFOs on a step
+		void
+		SelectNoteOption(uint32_t inStepNumber, Random &inRandom);
+
+		// the first step's, with the LFOs back at the start of their cycles
+		void
+		Rewind(Random &inRandom)
+		{
+			mLFOs.Reset();
+			SelectNoteOption(0, inRandom);
+		}
+
+		Step &GetStep(uint32_t inStepNumber)
+		{
+			return mSteps[inStepNumber];
+		}
+
+		const Step &GetStep(uint32_t inStepNumber) const
+		{
+			return mSteps[inStepNumber];
+		}
+
+		uint32_t
+		GetStepCount() const
+		{
+			return mSteps.size();
+		}
+
+		std::vector<AutomationLane> &
+		GetLanes()
+		{
+			return mLanes;
+		}
+
+		const std::vector<AutomationLane> &
+		GetLanes() const
+		{
+			return mLanes;
+		}
+
+		LFOBank &
+		GetLFOs()
+		{
+			return mLFOs;
+		}
+
+		const LFOBank &
+		GetLFOs() const
+		{
+			return mLFOs;
+		}
+
+	private:
+	
+		std::vector<Step>	mSteps;
+		std::vector<AutomationLane>	mLanes;
+
+		// carries on through the loop, so a cycle can be longer than the pattern
+		LFOBank	mLFOs;
+};
+
+#endif	// Sequence_h
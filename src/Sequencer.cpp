@@ -0,0 +1,863 @@
+// Sequencer.cpp
+
+// INCLUDES
+
+#include "Sequencer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "MIDICLOutputPort.h"
+#include "MIDICLScaleQuantiser.h"
+
+#include "ClockFollower.h"
+#include "HostTime.h"
+#include "PortOutput.h"
+#include "SequencerOutput.h"
+#include "Utility.h"
+
+Sequencer::Sequencer()
+	:
+	mTimerTicks(0),
+	mPortOutput(nullptr),
+	mOutput(nullptr),
+	mStepNumber(0),
+	mQuantiser(nullptr),
+	mInputQueue(nullptr),
+	mRatchetTable(RatchetTable::Get()),
+	mSequences(new std::vector<Sequence>(1)),
+	mSequence(&(*mSequences)[0]),
+	mSequenceNumber(0),
+	mNextSequence(nullptr),
+	mNextSequenceNumber(0),
+	mSequenceCount(1),
+	mQueuedSwitch(0),
+	mPublishedSequences(nullptr),
+	mBPM(120.0f),
+	mCommand(kNoCommand),
+	mCommandResult(false),
+	mState(kStopped),
+	mTickTime(0),
+	mTickInterval(0),
+	mSentTime(0),
+	mClockStats(),
+	mFollower(nullptr),
+	mPLL(60000000000.0 / (mBPM * kTicksPerQuarterNote)),
+	mFollowRunning(false),
+	mPulses(0),
+	mFollowTicks(0)
+{
+	for (std::atomic<std::vector<Sequence> *> &retired : mRetiredSequences)
+		retired = nullptr;
+
+	memset(mNoteOffs, 0xff, sizeof(mNoteOffs));
+	memset(mTiedNotes, 0, sizeof(mTiedNotes));
+	memset(mSentControls, 0xff, sizeof(mSentControls));
+}
+
+Sequencer::~Sequencer()
+{
+	if (mClockThread.joinable())
+	{
+		SendCommand(kStopCommand);
+		SendCommand(kQuitCommand);
+
+		mClockThread.join();
+	}
+
+	delete mPortOutput;
+
+	CollectSequences();
+
+	delete mPublishedSequences.exchange(nullptr);
+	delete mSequences;
+}
+
+bool
+Sequencer::Play(MIDICLOutputPort *inOutputPort)
+{
+	return Play(GetPortOutput(inOutputPort, mClockPorts));
+}
+
+bool
+Sequencer::Play(SequencerOutput *inOutput)
+{
+	// the clock thread only lets go of the output while stopped
+	if (inOutput != mOutput)
+	{
+		Stop();
+		mOutput = inOutput;
+	}
+
+	return SendCommand(kPlayCommand);
+}
+
+bool
+Sequencer::Continue()
+{
+	if (mOutput == nullptr)
+		return false;
+
+	return SendCommand(kContinueCommand);
+}
+
+void
+Sequencer::Locate(uint32_t inTick)
+{
+	SendCommand(kLocateCommand | (inTick << kCommandBits), false);
+}
+
+bool
+Sequencer::Follow(MIDICLOutputPort *inOutputPort, ClockFollower *inFollower)
+{
+	return Follow(GetPortOutput(inOutputPort, std::vector<MIDICLOutputPort *>()), inFollower);
+}
+
+bool
+Sequencer::Follow(SequencerOutput *inOutput, ClockFollower *inFollower)
+{
+	Stop();
+
+	mOutput = inOutput;
+	mFollower = inFollower;
+
+	return SendCommand(kFollowCommand);
+}
+
+void
+Sequencer::Stop()
+{
+	// nothing can be playing before the first command
+	if (mClockThread.joinable())
+		SendCommand(kStopCommand);
+}
+
+bool
+Sequencer::SendCommand(uint32_t inCommand, bool inWait)
+{
+	std::lock_guard<std::mutex>	commandLock(mCommandMutex);
+
+	if (!mClockThread.joinable())
+		mClockThread = std::thread(&Sequencer::RunClock, this);
+
+	// commands are over in microseconds, not worth sleeping for
+	auto	waitForCommand = [this]
+	{
+		while (mCommand.load(std::memory_order_acquire) != kNoCommand)
+			std::this_thread::yield();
+	};
+
+	// one that wasn't waited for gets taken before this one goes in
+	waitForCommand();
+
+	mCommand.store(inCommand, std::memory_order_release);
+
+	// the clock thread looks at the command under the lock before it sleeps
+	// so once we've had the lock it's either seen it or is waiting to be woken
+	{
+		std::lock_guard<std::mutex>	lock(mWakeMutex);
+	}
+
+	mWake.notify_one();
+
+	if (!inWait)
+		return false;
+
+	waitForCommand();
+
+	return mCommandResult;
+}
+
+PortOutput *
+Sequencer::GetPortOutput(MIDICLOutputPort *inOutputPort, const std::vector<MIDICLOutputPort *> &inClockPorts)
+{
+	// the same ports as last time keep the one there is
+	if (mPortOutput != nullptr && mPortOutput->SendsTo(inOutputPort, inClockPorts))
+		return mPortOutput;
+
+	// the clock thread only lets go of the output while stopped
+	Stop();
+
+	if (mOutput == mPortOutput)
+		mOutput = nullptr;
+
+	delete mPortOutput;
+	mPortOutput = new PortOutput(inOutputPort, inClockPorts);
+
+	return mPortOutput;
+}
+
+void
+Sequencer::SetSequences(const std::vector<Sequence> &inSequences, uint32_t inFirst)
+{
+	if (inSequences.size() == 0)
+		return;
+
+	*mSequences = inSequences;
+
+	mSequenceNumber = std::min(inFirst, (uint32_t) mSequences->size() - 1);
+	mSequence = &(*mSequences)[mSequenceNumber];
+	mNextSequence = nullptr;
+	mSequenceCount = mSequences->size();
+}
+
+void
+Sequencer::PublishSequences(std::vector<Sequence> *inSequences)
+{
+	if (inSequences->size() == 0)
+	{
+		delete inSequences;
+		return;
+	}
+
+	CollectSequences();
+
+	// one the tick never saw can go straight away
+	delete mPublishedSequences.exchange(inSequences);
+}
+
+void
+Sequencer::CollectSequences()
+{
+	for (std::atomic<std::vector<Sequence> *> &retired : mRetiredSequences)
+		delete retired.exchange(nullptr);
+}
+
+bool
+Sequencer::QueueSequence(uint32_t inSequenceNumber, SwitchPoint inSwitchPoint)
+{
+	// checked again at the switch, the sequences could be republished by then
+	if (inSequenceNumber >= mSequenceCount)
+		return false;
+
+	mQueuedSwitch.store((inSequenceNumber << 2) | inSwitchPoint);
+
+	return true;
+}
+
+void
+Sequencer::Render(SequencerOutput *inOutput, uint32_t inTicks)
+{
+	mOutput = inOutput;
+
+	Silence();
+
+	mSequence->Rewind(mRandom);
+	mNextSequence = nullptr;
+	mTimerTicks = 0;
+
+	for (uint32_t tick = 0; tick < inTicks; tick++)
+		TimerTick();
+
+	// anything still held is let go at the end, hits still to come aren't played
+	mWheel.Drain([this] (const TimedEvent &inEvent)
+	{
+		if (inEvent.mType == TimedEvent::kNoteOff)
+			HandleEvent(inEvent);
+	});
+	memset(mTiedNotes, 0, sizeof(mTiedNotes));
+}
+
+// the clock thread, waits for commands while stopped
+// and for the next deadline or incoming clock otherwise
+void
+Sequencer::RunClock()
+{
+	auto	commandWaiting = [this] { return mCommand.load(std::memory_order_acquire) != kNoCommand; };
+
+	for (;;)
+	{
+		uint32_t	command = mCommand.load(std::memory_order_acquire);
+
+		if (command != kNoCommand)
+		{
+			bool	quit = (command & kCommandMask) == kQuitCommand;
+			bool	result = quit || DoCommand(command);
+
+			// the sender spins on this, the result has to be there first
+			mCommandResult = result;
+			mCommand.store(kNoCommand, std::memory_order_release);
+
+			if (quit)
+				return;
+
+			continue;
+		}
+
+		uint64_t	now = HostTime::Now();
+		uint64_t	wake = 0;
+
+		if (mState == kPlaying)
+		{
+			// a wake up late enough to swallow a tick does both
+			if (now >= mTickTime)
+			{
+				ClockTick();
+				continue;
+			}
+
+			wake = mTickTime;
+		}
+		else if (mState == kFollowing)
+		{
+			wake = FollowClock(now);
+
+			if (wake <= now)
+				continue;
+		}
+
+		std::unique_lock<std::mutex>	lock(mWakeMutex);
+
+		// a command sent since we looked gets caught by the predicate
+		if (wake == 0)
+		{
+			mWake.wait(lock, commandWaiting);
+		}
+		else
+		{
+			now = HostTime::Now();
+
+			if (wake > now)
+				mWake.wait_for(lock, std::chrono::nanoseconds(wake - now), commandWaiting);
+		}
+	}
+}
+
+// on the clock thread, the only place the transport changes
+bool
+Sequencer::DoCommand(uint32_t inCommand)
+{
+	switch (inCommand & kCommandMask)
+	{
+		case kPlayCommand:
+			DoCommand(kStopCommand);
+
+			mSequence->Rewind(mRandom);
+			mNextSequence = nullptr;
+			mQueuedSwitch = 0;
+			mTimerTicks = 0;
+
+			StartClock(false);
+			return true;
+
+		case kContinueCommand:
+			if (mState != kStopped)
+				return false;
+
+			// slaves can only be told sixteenths
+			mTimerTicks -= mTimerTicks % kTicksPerSixteenth;
+
+			StartClock(true);
+			return true;
+
+		case kLocateCommand:
+		{
+			// the master decides where we are
+			if (mState == kFollowing)
+				return false;
+
+			bool			playing = mState == kPlaying;
+			uint32_t	tick = (inCommand >> kCommandBits) % (mSequence->GetStepCount() * kTicksPerStep);
+
+			if (playing)
+				DoCommand(kStopCommand);
+
+			// the step we land in gets its option picked like any other
+			mTimerTicks = tick - tick % kTicksPerSixteenth;
+			mNextSequence = nullptr;
+			mSequence->SelectNoteOption(mTimerTicks / kTicksPerStep, mRandom);
+
+			if (playing)
+				StartClock(true);
+
+			return true;
+		}
+
+		case kFollowCommand:
+			DoCommand(kStopCommand);
+
+			mSequence->Rewind(mRandom);
+			mNextSequence = nullptr;
+			mQueuedSwitch = 0;
+			mTimerTicks = 0;
+
+			mPLL = ClockPLL(60000000000.0 / (mBPM * kTicksPerQuarterNote));
+			mFollowRunning = false;
+			mPulses = 0;
+			mFollowTicks = 0;
+
+			mState = kFollowing;
+			return true;
+
+		case kStopCommand:
+			if (mState == kPlaying)
+			{
+				// with the last clock, so after everything already stamped
+				mOutput->SetTime(mSentTime);
+
+				Silence();
+				mOutput->SendStop();
+
+				mOutput->SetTime(0);
+			}
+			else if (mState == kFollowing)
+			{
+				Silence();
+			}
+
+			mState = kStopped;
+			return true;
+	}
+
+	return false;
+}
+
+// when things go out comes from the deadlines, not from when we wake up
+void
+Sequencer::StartClock(bool inContinue)
+{
+	uint64_t	now = HostTime::Now();
+
+	mTickInterval = (uint64_t) (60000000000.0 / (mBPM * kTicksPerQuarterNote));
+	mTickTime = now + kStartGap;
+	mClockStats = ClockStats();
+
+	// anything slaved to us carries on from the first clock
+	mSentTime = now + kClockLookahead;
+	mOutput->SetTime(mSentTime);
+
+	if (inContinue)
+	{
+		mOutput->SendSongPosition(mTimerTicks / kTicksPerSixteenth);
+		mOutput->SendContinue();
+	}
+	else
+	{
+		mOutput->SendStart();
+	}
+
+	mState = kPlaying;
+}
+
+// a tick off our own clock, clock and notes stamped with the same deadline
+void
+Sequencer::ClockTick()
+{
+	int64_t	lateness = (int64_t) (HostTime::Now() - mTickTime);
+
+	mClockStats.mTicks++;
+	mClockStats.mTotal += lateness;
+	mClockStats.mTotalSquares += (double) lateness * lateness;
+	mClockStats.mLatest = std::max(mClockStats.mLatest, lateness);
+
+	if (lateness > (int64_t) kClockLookahead)
+		mClockStats.mMissed++;
+
+	mSentTime = mTickTime + kClockLookahead;
+	mOutput->SetTime(mSentTime);
+	mOutput->SendClock();
+
+	TimerTick();
+
+	mTickTime += mTickInterval;
+}
+
+// one go round following, one tick per incoming pulse
+// ticks land on the PLL's grid rather than when the pulses arrived
+// and never get ahead of the pulses, so we can't drift from the master
+// returns when to look again
+uint64_t
+Sequencer::FollowClock(uint64_t inNow)
+{
+	ClockFollower::Event	event;
+
+	while (mFollower->Pop(event))
+	{
+		switch (event.mType)
+		{
+			case ClockFollower::kStart:
+				// the first clock after a start is the downbeat
+				mTimerTicks = 0;
+				mSequence->Rewind(mRandom);
+				// fall through
+
+			case ClockFollower::kContinue:
+				Silence();
+
+				mPLL.Reset();
+				mPulses = 0;
+				mFollowTicks = 0;
+				mFollowRunning = true;
+				break;
+
+			case ClockFollower::kStop:
+				Silence();
+
+				mFollowRunning = false;
+				break;
+
+			case ClockFollower::kClock:
+				if (mFollowRunning)
+				{
+					// gates were timed at the old tempo
+					if (mPLL.Pulse(event.mTime))
+						Silence();
+
+					mPulses++;
+				}
+				break;
+		}
+	}
+
+	uint64_t	wake = inNow + kFollowPoll;
+
+	if (mFollowTicks < mPulses)
+	{
+		uint64_t	due = mPLL.GetTime(mFollowTicks) + kFollowLatency;
+
+		if (due <= inNow)
+		{
+			TimerTick();
+			mFollowTicks++;
+
+			return inNow;
+		}
+
+		wake = std::min(wake, due);
+	}
+
+	return wake;
+}
+
+// this goes off at 24ppqn
+// HACK hardwire steps to quaver length
+void
+Sequencer::TimerTick()
+{
+	uint32_t		stepNumber = mTimerTicks / kTicksPerStep;
+	uint32_t		subtick = mTimerTicks % kTicksPerStep;
+	NoteOption	*selectedOption = mSequence->GetSelectedNoteOption(stepNumber);
+
+	// what the ports heard since the last tick, before anything's decided
+	if (mInputQueue)
+	{
+		auto	hear = [this] (const MIDICLEventQueue::Event &inEvent) { HearInput(inEvent); };
+
+		mInputQueue->Drain(hear);
+	}
+
+	// what's come due goes first, so a note can end and start on the same tick
+	mWheel.Advance([this] (const TimedEvent &inEvent) { HandleEvent(inEvent); });
+
+	// controllers before the step's notes, so the notes start with them set
+	for (const AutomationLane &lane : mSequence->GetLanes())
+		Automate(lane, stepNumber, subtick);
+
+	if (subtick == 0)
+	{
+		uint64_t	tiedNotes[2] = { mTiedNotes[0], mTiedNotes[1] };
+
+		mTiedNotes[0] = mTiedNotes[1] = 0;
+
+		// new step
+		if (selectedOption)
+		{
+			// chords are built on the quantised note, so they keep their shape
+			Byte			note = mQuantiser ? mQuantiser->Quantise(selectedOption->mNote) : selectedOption->mNote;
+			Byte			notes[NoteOption::kMaximumChordNotes];
+			uint32_t	noteCount = selectedOption->GetChordNotes(note, notes);
+
+			for (uint32_t noteNumber = 0; noteNumber < noteCount; noteNumber++)
+				StartNote(*selectedOption, notes[noteNumber], tiedNotes);
+		}
+	}
+
+	// this is a good spot to calculate the next step's option
+	// even if this step didn't select one
+	if (subtick == kTicksPerStep - 1)
+	{
+		uint32_t	queuedSwitch = mQueuedSwitch.load(std::memory_order_acquire);
+		bool			barEnds = (mTimerTicks + 1) % kTicksPerBar == 0;
+		bool			loopEnds = stepNumber + 1 == mSequence->GetStepCount();
+
+		std::vector<Sequence>	*sequences = mSequences;
+
+		// newly published sequences only come in at the end of a loop
+		if (loopEnds && mPublishedSequences.load(std::memory_order_relaxed))
+		{
+			sequences = mPublishedSequences.exchange(nullptr, std::memory_order_acquire);
+
+			if (sequences == nullptr)
+				sequences = mSequences;
+		}
+
+		uint32_t	nextSequenceNumber = std::min(mSequenceNumber, (uint32_t) sequences->size() - 1);
+
+		if (queuedSwitch != 0
+			&& (loopEnds || (barEnds && (queuedSwitch & 3) == kSwitchAtBar))
+			&& mQueuedSwitch.compare_exchange_strong(queuedSwitch, 0)
+			&& (queuedSwitch >> 2) < sequences->size())
+		{
+			nextSequenceNumber = queuedSwitch >> 2;
+		}
+		else if (sequences == mSequences)
+		{
+			// no switch
+			nextSequenceNumber = UINT32_MAX;
+		}
+
+		if (nextSequenceNumber != UINT32_MAX)
+		{
+			if (sequences != mSequences)
+			{
+				// nothing touches the old ones after this
+				std::vector<Sequence>	*retiring = mSequences;
+
+				mSequences = sequences;
+				mSequenceCount = sequences->size();
+
+				for (std::atomic<std::vector<Sequence> *> &retired : mRetiredSequences)
+				{
+					std::vector<Sequence>	*empty = nullptr;
+
+					if (retired.compare_exchange_strong(empty, retiring))
+					{
+						retiring = nullptr;
+						break;
+					}
+				}
+
+				// with every slot full we'd rather leak than free on the tick
+			}
+
+			// the next sequence's first step is ready before it's due
+			mNextSequence = &(*mSequences)[nextSequenceNumber];
+			mNextSequenceNumber = nextSequenceNumber;
+			mNextSequence->SelectNoteOption(0, mRandom);
+		}
+		else
+		{
+			mSequence->SelectNoteOption((stepNumber + 1) % mSequence->GetStepCount(), mRandom);
+		}
+	}
+
+	mOutput->Tick();
+
+	mTimerTicks++;
+	
+	if (mNextSequence)
+	{
+		// nothing carries over into a different pattern
+		Silence();
+
+		mSequence = mNextSequence;
+		mSequenceNumber = mNextSequenceNumber;
+		mNextSequence = nullptr;
+		mTimerTicks = 0;
+	}
+	else if (mTimerTicks / kTicksPerStep == mSequence->GetStepCount())
+	{
+		mTimerTicks = 0;
+	}
+}
+
+// one note of a step, along with its note off or ratchet
+// inTiedNotes has a bit for each of the last step's notes that was tied
+void
+Sequencer::StartNote(const NoteOption &inOption, Byte inNote, const uint64_t inTiedNotes[2])
+{
+	bool	tied = (inTiedNotes[inNote >> 6] >> (inNote & 63)) & 1;
+
+	// tied into the same note it just carries on
+	// otherwise whatever's still holding it ends first
+	if (!tied || !TakeNoteOff(inNote, false))
+	{
+		TakeNoteOff(inNote, true);
+		mOutput->SendNoteOn(0, inNote, inOption.mVelocity);
+	}
+
+	if (inOption.mRatchet)
+	{
+		// the rest of the hits go in the wheel now, so the ticks between don't look
+		uint32_t	count = inOption.mRatchetCount;
+		uint32_t	spacing = inOption.mRatchetSpacing;
+
+		if (count > RatchetTable::kMaximumCount)
+			count = RatchetTable::kMaximumCount;
+
+		if (spacing > RatchetTable::kMaximumSpacing)
+			spacing = RatchetTable::kMaximumSpacing;
+
+		Byte	gate = spacing > 1 ? spacing - 1 : 1;
+
+		const uint16_t	*offsets = mRatchetTable.GetOffsets(spacing);
+		const uint16_t	*gains = mRatchetTable.GetGains(inOption.mRatchetDecay);
+
+		ScheduleNoteOff(inNote, inOption.mVelocity, gate);
+
+		for (uint32_t hit = 1; hit < count; hit++)
+		{
+			Byte				velocity = std::max((inOption.mVelocity * gains[hit]) >> 8, 1);
+			TimedEvent	event = { TimedEvent::kNoteOn, 0, inNote, velocity, gate };
+
+			mWheel.Schedule(offsets[hit], event);
+		}
+	}
+	else
+	{
+		// percent of the step, past the end of it is fine
+		uint32_t	gate = kTicksPerStep * std::max((int) inOption.mGateTime, 0) / 100;
+
+		// a tie holds until a tick after the next step starts, which is legato
+		if (inOption.mTie)
+		{
+			gate = std::max(gate, kTicksPerStep + 1);
+			mTiedNotes[inNote >> 6] |= 1ULL << (inNote & 63);
+		}
+
+		ScheduleNoteOff(inNote, inOption.mVelocity, gate);
+	}
+}
+
+// on the tick, and wherever the transport stops or jumps
+void
+Sequencer::Silence()
+{
+	mWheel.Clear();
+	memset(mNoteOffs, 0xff, sizeof(mNoteOffs));
+	memset(mTiedNotes, 0, sizeof(mTiedNotes));
+	memset(mSentControls, 0xff, sizeof(mSentControls));
+
+	mOutput->StopSounding();
+}
+
+void
+Sequencer::ScheduleNoteOff(Byte inKey, Byte inVelocity, uint32_t inTicks)
+{
+	TimedEvent	event = { TimedEvent::kNoteOff, 0, inKey, inVelocity, 0 };
+	uint16_t		handle = mWheel.Schedule(inTicks, event);
+
+	// a short note rather than a stuck one
+	if (handle == TimingWheel::kNoEvent)
+		mOutput->SendNoteOff(0, inKey, inVelocity);
+
+	mNoteOffs[inKey & 0x7f] = handle;
+}
+
+bool
+Sequencer::TakeNoteOff(Byte inKey, bool inSend)
+{
+	uint16_t	handle = mNoteOffs[inKey & 0x7f];
+
+	if (handle == TimingWheel::kNoEvent)
+		return false;
+
+	if (inSend)
+		HandleEvent(mWheel.GetEvent(handle));
+
+	mWheel.Cancel(handle);
+	mNoteOffs[inKey & 0x7f] = TimingWheel::kNoEvent;
+
+	return true;
+}
+
+void
+Sequencer::HandleEvent(const TimedEvent &inEvent)
+{
+	switch (inEvent.mType)
+	{
+		case TimedEvent::kNoteOff:
+			mNoteOffs[inEvent.mKey & 0x7f] = TimingWheel::kNoEvent;
+			mOutput->SendNoteOff(inEvent.mChannel, inEvent.mKey, inEvent.mVelocity);
+			break;
+
+		case TimedEvent::kNoteOn:
+			TakeNoteOff(inEvent.mKey, true);
+			mOutput->SendNoteOn(inEvent.mChannel, inEvent.mKey, inEvent.mVelocity);
+			ScheduleNoteOff(inEvent.mKey, inEvent.mVelocity, inEvent.mGate);
+			break;
+	}
+}
+
+void
+Sequencer::HearInput(const MIDICLEventQueue::Event &inEvent)
+{
+	const MIDICLMessage	&message = inEvent.mMessage;
+
+	// on any channel, from any port
+	if ((message.mStatus & 0xf0) == 0xc0 && message.mData[0] < mSequences->size())
+		mQueuedSwitch.store((message.mData[0] << 2) | kSwitchAtBar, std::memory_order_release);
+}
+
+void
+Sequencer::Automate(const AutomationLane &inLane, uint32_t inStepNumber, uint32_t inSubtick)
+{
+	uint32_t	stepCount = inLane.mValues.size();
+
+	if (inStepNumber >= stepCount)
+		return;
+
+	int	value = inLane.mValues[inStepNumber];
+
+	if (value == AutomationLane::kNoValue)
+		return;
+
+	if (inSubtick > 0)
+	{
+		if (!inLane.mInterpolate)
+			return;
+
+		// towards the next step's value, which wraps to the first
+		int	nextValue = inLane.mValues[(inStepNumber + 1) % stepCount];
+
+		if (nextValue == AutomationLane::kNoValue)
+			return;
+
+		value += (nextValue - value) * (int) inSubtick / (int) kTicksPerStep;
+	}
+
+	SendControl(inLane.mType, inLane.mChannel, inLane.mController, value);
+}
+
+void
+Sequencer::SendControl(uint8_t inType, Byte inChannel, Byte inController, int inValue)
+{
+	bool	pitchBend = inType == AutomationLane::kPitchBend;
+	int		maximum = pitchBend ? 16383 : 127;
+
+	if (inValue < 0)
+		inValue = 0;
+	else if (inValue > maximum)
+		inValue = maximum;
+
+	int16_t	&sent = mSentControls[inChannel & 0xf][pitchBend ? 128 : inController & 0x7f];
+
+	if (sent == inValue)
+		return;
+
+	sent = inValue;
+
+	if (pitchBend)
+		mOutput->SendPitchBend(inChannel & 0xf, inValue);
+	else
+		mOutput->SendControlChange(inChannel & 0xf, inController, inValue);
+}
+
+void
+Sequencer::ClockStats::Print() const
+{
+	if (mTicks == 0)
+		return;
+
+	double	mean = mTotal / mTicks;
+	double	deviation = sqrt(std::max(0.0, mTotalSquares / mTicks - mean * mean));
+
+	printf("%u ticks woke %.3fms after their deadlines with %.3fms deviation, %.3fms at worst,\n"
+		"%u later than the %.1fms lookahead\n",
+		mTicks, mean / 1000000.0, deviation / 1000000.0, mLatest / 1000000.0,
+		mMissed, kClockLookahead / 1000000.0);
+}
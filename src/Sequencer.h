@@ -0,0 +1,372 @@
+// Sequencer.h
+
+// GUARD
+
+#ifndef Sequencer_h
+#define Sequencer_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MIDICLEventQueue.h"
+
+#include "AutomationLane.h"
+#include "ClockPLL.h"
+#include "NoteOption.h"
+#include "Random.h"
+#include "RatchetTable.h"
+#include "Sequence.h"
+#include "TimingWheel.h"
+
+// FORWARD DECLARATIONS
+
+class ClockFollower;
+class MIDICLOutputPort;
+class MIDICLScaleQuantiser;
+class PortOutput;
+class SequencerOutput;
+
+// CONSTANTS
+
+// this goes off at 24ppqn
+// HACK hardwire steps to quaver length
+static const uint32_t	kTicksPerQuarterNote = 24;
+static const uint32_t	kTicksPerStep = kTicksPerQuarterNote / 2;
+static const uint32_t	kTicksPerBar = kTicksPerQuarterNote * 4;
+
+// what song position pointers count in
+static const uint32_t	kTicksPerSixteenth = kTicksPerQuarterNote / 4;
+
+// playing off our own clock, everything is stamped this far past its deadline
+// wake ups later than that show up as jitter
+static const uint64_t	kClockLookahead = 5000000;
+
+// some slaves want a moment between a start and the first clock
+static const uint64_t	kStartGap = 1000000;
+
+// how often we look for incoming clock when following and nothing's due
+static const uint64_t	kFollowPoll = 1000000;
+
+// following, ticks go out this long after their smoothed pulse time
+// more than the jitter on the incoming clock, or the jitter shows
+static const uint64_t	kFollowLatency = 4000000;
+
+// CLASS
+
+class Sequencer
+{
+	public:
+	
+		Sequencer();
+
+		~Sequencer();
+
+		// the transport runs on one clock thread for the life of the sequencer
+		// these hand it a command and return once it's been acted on
+
+		// from the top, sending start and clock to the clock ports
+		bool
+		Play(MIDICLOutputPort *inOutputPort);
+
+		bool
+		Play(SequencerOutput *inOutput);
+
+		// from the sixteenth we stopped in, after a song position pointer
+		bool
+		Continue();
+
+		// to the sixteenth at or before inTick into the sequence, playing or not
+		// returns without waiting, the next command goes in after it
+		void
+		Locate(uint32_t inTick);
+
+		// only while stopped, Play() sends clock and transport to these
+		void
+		SetClockPorts(const std::vector<MIDICLOutputPort *> &inClockPorts)
+		{
+			mClockPorts = inClockPorts;
+		}
+
+		// ticks on the clock heard by inFollower instead of our own
+		// waits for a start or continue before playing anything
+		bool
+		Follow(MIDICLOutputPort *inOutputPort, ClockFollower *inFollower);
+
+		bool
+		Follow(SequencerOutput *inOutput, ClockFollower *inFollower);
+	
+		// keeps the position, so Continue() carries on from here
+		void
+		Stop();
+
+		// runs the tick logic flat out with no clock
+		void
+		Render(SequencerOutput *inOutput, uint32_t inTicks);
+
+		void
+		SetBPM(float inBPM)
+		{
+			mBPM = inBPM;
+		}
+
+		float
+		GetBPM() const
+		{
+			return mBPM;
+		}
+
+		// the one playing, or that will play
+		Sequence &
+		GetSequence()
+		{
+			return *mSequence;
+		}
+
+		// only while stopped, inFirst plays first
+		void
+		SetSequences(const std::vector<Sequence> &inSequences, uint32_t inFirst = 0);
+
+		uint32_t
+		GetSequenceCount() const
+		{
+			return mSequenceCount;
+		}
+
+		// from any thread while playing, takes ownership
+		// replaces the whole lot at the end of the current loop
+		// the playing sequence number carries on unless a switch is queued
+		void
+		PublishSequences(std::vector<Sequence> *inSequences);
+
+		// frees sequences the tick has finished with
+		// call from the thread that publishes, never the tick
+		void
+		CollectSequences();
+
+		enum SwitchPoint
+		{
+			kSwitchAtBar = 1,
+			kSwitchAtLoop = 2
+		};
+
+		// from any thread while playing
+		// the sequence starts from its first step at the switch point
+		// a later call replaces one that hasn't happened yet
+		bool
+		QueueSequence(uint32_t inSequenceNumber, SwitchPoint inSwitchPoint);
+
+		void
+		Seed(uint64_t inSeed)
+		{
+			mRandom.Seed(inSeed);
+		}
+
+		// only while stopped, puts every step's note on a scale
+		// changing the scale or transpose on inQuantiser takes effect from the next step
+		void
+		SetQuantiser(const MIDICLScaleQuantiser *inQuantiser)
+		{
+			mQuantiser = inQuantiser;
+		}
+
+		const MIDICLScaleQuantiser *
+		GetQuantiser() const
+		{
+			return mQuantiser;
+		}
+
+		// only while stopped, each tick starts by acting on what the input ports queued there
+		// a program change switches to that pattern at the next bar
+		void
+		SetInputQueue(MIDICLEventQueue *inQueue)
+		{
+			mInputQueue = inQueue;
+		}
+
+		// how late the clock thread woke up against each tick's deadline
+		struct ClockStats
+		{
+			uint32_t	mTicks;
+
+			// later than the lookahead, so these went out late
+			uint32_t	mMissed;
+
+			// nanoseconds
+			double		mTotal;
+			double		mTotalSquares;
+			int64_t		mLatest;
+
+			// the mean, deviation and worst of them on stdout
+			void
+			Print() const;
+		};
+
+		// only while stopped, covers the last Play() or Continue()
+		const ClockStats &
+		GetClockStats() const
+		{
+			return mClockStats;
+		}
+
+		uint32_t		mTimerTicks;
+
+	private:
+
+		enum State
+		{
+			kStopped,
+			kPlaying,
+			kFollowing
+		};
+
+		// what the clock thread gets told to do
+		// the low bits, with a tick number above for locate
+		enum Command
+		{
+			kNoCommand,
+			kPlayCommand,
+			kContinueCommand,
+			kLocateCommand,
+			kFollowCommand,
+			kStopCommand,
+			kQuitCommand,
+
+			kCommandBits = 3,
+			kCommandMask = (1 << kCommandBits) - 1
+		};
+
+		// waits for the clock thread to act on it unless told not to
+		// false if it wasn't waited for
+		bool SendCommand(uint32_t inCommand, bool inWait = true);
+
+		// the port output from last time if it goes to the same ports, otherwise a new one
+		PortOutput *GetPortOutput(MIDICLOutputPort *inOutputPort, const std::vector<MIDICLOutputPort *> &inClockPorts);
+
+		void RunClock();
+
+		bool DoCommand(uint32_t inCommand);
+
+		void StartClock(bool inContinue);
+
+		void ClockTick();
+
+		uint64_t FollowClock(uint64_t inNow);
+
+		void TimerTick();
+
+		// turns off what's sounding, forgets what was waiting to and what the lanes sent
+		void Silence();
+
+		void StartNote(const NoteOption &inOption, Byte inNote, const uint64_t inTiedNotes[2]);
+
+		void ScheduleNoteOff(Byte inKey, Byte inVelocity, uint32_t inTicks);
+
+		// the note off waiting for inKey, sent now or dropped
+		// false if there wasn't one
+		bool TakeNoteOff(Byte inKey, bool inSend);
+
+		void HandleEvent(const TimedEvent &inEvent);
+
+		// one message from the input queue
+		void HearInput(const MIDICLEventQueue::Event &inEvent);
+
+		// the lane's value on this tick, if it has one
+		void Automate(const AutomationLane &inLane, uint32_t inStepNumber, uint32_t inSubtick);
+
+		// only goes out if it isn't what was last sent there
+		void SendControl(uint8_t inType, Byte inChannel, Byte inController, int inValue);
+
+
+		PortOutput				*mPortOutput;
+		SequencerOutput		*mOutput;
+
+		std::vector<MIDICLOutputPort *>	mClockPorts;
+		
+		int								mStepNumber;
+		Random						mRandom;
+
+		const MIDICLScaleQuantiser	*mQuantiser;
+
+		// the tick is its only consumer
+		MIDICLEventQueue	*mInputQueue;
+
+		// the tick owns these
+		TimingWheel				mWheel;
+		const RatchetTable	&mRatchetTable;
+
+		// everything goes out on channel 0, so one handle per key
+		uint16_t					mNoteOffs[128];
+
+		// a bit for each of the last step's notes that was tied
+		uint64_t					mTiedNotes[2];
+
+		// what the lanes last sent, per channel and controller, pitch bend last
+		// -1 if nothing has been
+		int16_t					mSentControls[16][129];
+
+		// the tick owns these
+		std::vector<Sequence>	*mSequences;
+		Sequence					*mSequence;
+		uint32_t					mSequenceNumber;
+		Sequence					*mNextSequence;
+		uint32_t					mNextSequenceNumber;
+
+		std::atomic<uint32_t>	mSequenceCount;
+
+		// sequence number << 2 | switch point, zero when nothing's queued
+		std::atomic<uint32_t>	mQueuedSwitch;
+
+		// published sequences waiting for the end of the loop
+		std::atomic<std::vector<Sequence> *>	mPublishedSequences;
+
+		// ones the tick has finished with, for CollectSequences()
+		static const uint32_t	kRetiredSequencesCount = 4;
+
+		std::atomic<std::vector<Sequence> *>	mRetiredSequences[kRetiredSequencesCount];
+
+		float							mBPM;
+		
+		// clock thread stuff
+
+		std::thread							mClockThread;
+
+		// one caller at a time
+		std::mutex							mCommandMutex;
+
+		// the command waiting for the clock thread, kNoCommand once it's done
+		std::atomic<uint32_t>		mCommand;
+		bool										mCommandResult;
+
+		// only for the clock thread to sleep on
+		std::mutex							mWakeMutex;
+		std::condition_variable	mWake;
+
+		// the clock thread owns the rest
+		State							mState;
+
+		// the next tick's deadline and the gap between them, in host nanoseconds
+		uint64_t					mTickTime;
+		uint64_t					mTickInterval;
+
+		// what the last thing sent was stamped with
+		uint64_t					mSentTime;
+
+		ClockStats				mClockStats;
+
+		// follow stuff
+
+		ClockFollower			*mFollower;
+		ClockPLL					mPLL;
+		bool							mFollowRunning;
+		uint32_t					mPulses;
+		uint32_t					mFollowTicks;
+};
+
+#endif	// Sequencer_h
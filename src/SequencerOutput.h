@@ -0,0 +1,95 @@
+// SequencerOutput.h
+
+// GUARD
+
+#ifndef SequencerOutput_h
+#define SequencerOutput_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// where the sequencer sends its events
+// live playback wraps a MIDICLOutputPort
+// offline rendering writes a Standard MIDI File
+
+class SequencerOutput
+{
+	public:
+
+		virtual
+		~SequencerOutput()
+		{
+		}
+
+		virtual void
+		SendNoteOn(Byte inChannel, Byte inKey, Byte inVelocity) = 0;
+
+		virtual void
+		SendNoteOff(Byte inChannel, Byte inKey, Byte inVelocity) = 0;
+
+		// only from automation lanes, so outputs that just want notes can leave these
+		virtual void
+		SendControlChange(Byte inChannel, Byte inController, Byte inValue)
+		{
+		}
+
+		// 0 to 16383, 8192 is the middle
+		virtual void
+		SendPitchBend(Byte inChannel, uint16_t inValue)
+		{
+		}
+
+		// called once at the end of every tick
+		virtual void
+		Tick()
+		{
+		}
+
+		// the rest only matter live
+
+		// note offs for whatever is still sounding
+		virtual void
+		StopSounding()
+		{
+		}
+
+		// everything until the next call goes out at inTime
+		// in host nanoseconds, zero means straight away
+		virtual void
+		SetTime(uint64_t inTime)
+		{
+		}
+
+		virtual void
+		SendClock()
+		{
+		}
+
+		virtual void
+		SendStart()
+		{
+		}
+
+		virtual void
+		SendContinue()
+		{
+		}
+
+		virtual void
+		SendStop()
+		{
+		}
+
+		// in sixteenths
+		virtual void
+		SendSongPosition(uint32_t inPosition)
+		{
+		}
+};
+
+#endif	// SequencerOutput_h
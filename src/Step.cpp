@@ -0,0 +1,81 @@
+// Step.cpp
+
+// INCLUDES
+
+#include "Step.h"
+
+#include "LFOBank.h"
+#include "Utility.h"
+
+void
+Step::SelectNoteOption(Random &inRandom, const int16_t *inOffsets)
+{
+	// how much validation here do we really need to do?
+	// remember that it's possible that we don't select an option at all
+
+	static const int16_t	kNoOffsets[LFOBank::kTargetCount] = { 0 };
+
+	const int16_t	*offsets = inOffsets ? inOffsets : kNoOffsets;
+
+	mSelectedOption = -1;
+
+	uint8_t		roll = (uint8_t) inRandom.Below(100);
+	uint32_t	target = 0;
+
+	for (uint32_t optionNumber = 0; optionNumber < mNoteOptions.size(); optionNumber++)
+	{
+		target += Utility::Clamp(mNoteOptions[optionNumber].mProbability + offsets[LFOBank::kProbability], 0, 100);
+
+		if (roll < target)
+		{
+			mSelectedOption = optionNumber;
+			break;
+		}
+	}
+
+	// this is entirely possible and accepted
+	if (mSelectedOption < 0)
+		return;
+
+	// determine the property values
+
+	NoteOption	*selectedOption = &mNoteOptions[mSelectedOption];
+
+	// the upper ends can't be pushed under the lower ones
+	int16_t	gateTimeLower = Utility::Clamp
+		(selectedOption->mGateTimeLower + offsets[LFOBank::kGateTimeLower], INT16_MIN, INT16_MAX);
+	int16_t	gateTimeUpper = Utility::Clamp
+		(selectedOption->mGateTimeUpper + offsets[LFOBank::kGateTimeUpper], gateTimeLower, INT16_MAX);
+	uint8_t	noteLower = Utility::Clamp
+		(selectedOption->mNoteLower + offsets[LFOBank::kNoteLower], 0, 127);
+	uint8_t	noteUpper = Utility::Clamp
+		(selectedOption->mNoteUpper + offsets[LFOBank::kNoteUpper], noteLower, 127);
+	uint8_t	velocityLower = Utility::Clamp
+		(selectedOption->mVelocityLower + offsets[LFOBank::kVelocityLower], 0, 127);
+	uint8_t	velocityUpper = Utility::Clamp
+		(selectedOption->mVelocityUpper + offsets[LFOBank::kVelocityUpper], velocityLower, 127);
+
+	selectedOption->mMute = Utility::SelectProbability(inRandom, Utility::Clamp
+		(selectedOption->mMuteProbability + offsets[LFOBank::kMuteProbability], 0, 100));
+	selectedOption->mTie = Utility::SelectProbability(inRandom, Utility::Clamp
+		(selectedOption->mTieProbability + offsets[LFOBank::kTieProbability], 0, 100));
+
+	selectedOption->mGateTime = Utility::SelectValue<int16_t>
+		(inRandom, gateTimeLower, gateTimeUpper);
+
+	selectedOption->mNote = Utility::SelectValue<uint8_t>
+		(inRandom, noteLower, noteUpper);
+
+	selectedOption->mVelocity = Utility::SelectValue<uint8_t>
+		(inRandom, velocityLower, velocityUpper);
+
+	selectedOption->mRatchet = Utility::SelectProbability(inRandom, Utility::Clamp
+		(selectedOption->mRatchetProbability + offsets[LFOBank::kRatchetProbability], 0, 100));
+
+	// only chords roll for this, so patterns without them play as they always did
+	if (selectedOption->mChordIntervals != 0)
+	{
+		selectedOption->mInversion = Utility::SelectValue<uint8_t>
+			(inRandom, selectedOption->mInversionLower, selectedOption->mInversionUpper);
+	}
+}
@@ -0,0 +1,60 @@
+// Step.h
+
+// GUARD
+
+#ifndef Step_h
+#define Step_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "NoteOption.h"
+#include "Random.h"
+
+// CLASS
+
+class Step
+{
+	public:
+
+		Step()
+			:
+			mSelectedOption(-1),
+			mNoteOptions(2)
+		{
+		}
+
+		NoteOption *
+		GetSelectedNoteOption()
+		{
+			return mSelectedOption < 0 ? nullptr : &mNoteOptions[mSelectedOption];
+		}
+
+		// inOffsets, if there are any, move the ranges first
+		// indexed by LFOBank::Target
+		void
+		SelectNoteOption(Random &inRandom, const int16_t *inOffsets = nullptr);
+
+		NoteOption &
+		GetNoteOption(uint32_t inOptionNumber)
+		{
+			return mNoteOptions[inOptionNumber];
+		}
+
+		const NoteOption &
+		GetNoteOption(uint32_t inOptionNumber) const
+		{
+			return mNoteOptions[inOptionNumber];
+		}
+		
+	private:
+
+		// an index rather than a pointer so that steps copy safely
+		int32_t										mSelectedOption;
+		std::vector<NoteOption>		mNoteOptions;
+};
+
+#endif	// Step_h
@@ -0,0 +1,35 @@
+// TimedEvent.h
+
+// GUARD
+
+#ifndef TimedEvent_h
+#define TimedEvent_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <CoreMIDI/MIDIServices.h>
+
+// CLASS
+
+// what a TimingWheel hands back when it comes due
+
+struct TimedEvent
+{
+	enum Type
+	{
+		kNoteOff,
+		kNoteOn
+	};
+
+	uint8_t	mType;
+	Byte		mChannel;
+	Byte		mKey;
+	Byte		mVelocity;
+
+	// ticks a note on lasts
+	uint8_t	mGate;
+};
+
+#endif	// TimedEvent_h
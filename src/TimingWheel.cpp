@@ -0,0 +1,85 @@
+// TimingWheel.cpp
+
+// INCLUDES
+
+#include "TimingWheel.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+uint16_t
+TimingWheel::Schedule(uint32_t inTicks, const TimedEvent &inEvent)
+{
+	if (mFree == kNoEvent)
+		return kNoEvent;
+
+	uint16_t	node = mFree;
+
+	mFree = mNodes[node].mNext;
+	mCount++;
+
+	mNodes[node].mTick = mTick + std::max(inTicks, (uint32_t) 1) - 1;
+	mNodes[node].mEvent = inEvent;
+
+	Insert(node);
+
+	return node;
+}
+
+void
+TimingWheel::Insert(uint16_t inNode)
+{
+	Node			&node = mNodes[inNode];
+	uint32_t	delta = node.mTick - mTick;
+	uint32_t	tick = delta < kSpan ? node.mTick : mTick + kSpan - 1;
+	uint32_t	level = 0;
+
+	while (level + 1 < kLevelCount && delta >= 1U << (kSlotBits * (level + 1)))
+		level++;
+
+	uint16_t	slot = level * kSlotCount + ((tick >> (kSlotBits * level)) & kSlotMask);
+
+	node.mSlot = slot;
+	node.mPrevious = kNoEvent;
+	node.mNext = mSlots[slot];
+
+	if (node.mNext != kNoEvent)
+		mNodes[node.mNext].mPrevious = inNode;
+
+	mSlots[slot] = inNode;
+}
+
+void
+TimingWheel::Cancel(uint16_t inHandle)
+{
+	Node	&node = mNodes[inHandle];
+
+	if (node.mSlot == kNoSlot)
+		return;
+
+	if (node.mPrevious == kNoEvent)
+		mSlots[node.mSlot] = node.mNext;
+	else
+		mNodes[node.mPrevious].mNext = node.mNext;
+
+	if (node.mNext != kNoEvent)
+		mNodes[node.mNext].mPrevious = node.mPrevious;
+
+	Free(inHandle);
+}
+
+void
+TimingWheel::Clear()
+{
+	for (uint16_t node = 0; node < kPoolSize; node++)
+	{
+		mNodes[node].mSlot = kNoSlot;
+		mNodes[node].mNext = node + 1U < kPoolSize ? node + 1 : kNoEvent;
+	}
+
+	memset(mSlots, 0xff, sizeof(mSlots));
+
+	mFree = 0;
+	mCount = 0;
+}
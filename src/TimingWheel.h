@@ -0,0 +1,193 @@
+// TimingWheel.h
+
+// GUARD
+
+#ifndef TimingWheel_h
+#define TimingWheel_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include "TimedEvent.h"
+
+// CLASS
+
+// events due some number of ticks from now, note offs mostly
+// three levels of 64 slots, each slot a list, so inserting and expiring don't search
+// something far off waits in a coarse slot and drops a level each time its slot comes round
+// nodes come out of a fixed pool, so nothing allocates on the tick
+
+class TimingWheel
+{
+	public:
+
+		static const uint16_t	kNoEvent = 0xffff;
+
+		TimingWheel()
+			:
+			mTick(0)
+		{
+			Clear();
+		}
+
+		// inTicks after the tick last advanced over, so 1 is the next one
+		// returns a handle for Cancel(), or kNoEvent if the pool's used up
+		uint16_t
+		Schedule(uint32_t inTicks, const TimedEvent &inEvent);
+
+		// only with a handle that hasn't come due
+		void
+		Cancel(uint16_t inHandle);
+
+		const TimedEvent &
+		GetEvent(uint16_t inHandle) const
+		{
+			return mNodes[inHandle].mEvent;
+		}
+
+		// hands inHandler everything due on the next tick
+		// it can schedule and cancel from there
+		template <class Handler>
+		void
+		Advance(Handler inHandler);
+
+		// hands inHandler everything still waiting, in no particular order
+		template <class Handler>
+		void
+		Drain(Handler inHandler);
+
+		// forgets everything still waiting
+		void
+		Clear();
+
+		uint32_t
+		GetCount() const
+		{
+			return mCount;
+		}
+
+	private:
+
+		static const uint32_t	kSlotBits = 6;
+		static const uint32_t	kSlotCount = 1 << kSlotBits;
+		static const uint32_t	kSlotMask = kSlotCount - 1;
+		static const uint32_t	kLevelCount = 3;
+
+		// anything further off goes round the top level again
+		static const uint32_t	kSpan = 1 << (kSlotBits * kLevelCount);
+
+		static const uint32_t	kPoolSize = 1024;
+
+		// what a free node's mSlot says
+		static const uint16_t	kNoSlot = 0xffff;
+
+		// the list Expire() is working through, after the wheel's own
+		static const uint16_t	kExpiringSlot = kLevelCount * kSlotCount;
+
+		struct Node
+		{
+			uint32_t		mTick;
+			uint16_t		mNext;
+			uint16_t		mPrevious;
+			uint16_t		mSlot;
+			TimedEvent	mEvent;
+		};
+
+		void
+		Insert(uint16_t inNode);
+
+		void
+		Free(uint16_t inNode)
+		{
+			mNodes[inNode].mSlot = kNoSlot;
+			mNodes[inNode].mNext = mFree;
+			mFree = inNode;
+			mCount--;
+		}
+
+		// detaches a slot's list and returns its first node
+		uint16_t
+		Take(uint32_t inSlot)
+		{
+			uint16_t	node = mSlots[inSlot];
+
+			mSlots[inSlot] = kNoEvent;
+
+			return node;
+		}
+
+		// hands inHandler everything in a slot
+		template <class Handler>
+		void
+		Expire(uint32_t inSlot, Handler inHandler);
+
+		Node			mNodes[kPoolSize];
+		uint16_t	mSlots[kLevelCount * kSlotCount + 1];
+		uint16_t	mFree;
+		uint32_t	mCount;
+
+		// the tick Advance() does next
+		uint32_t	mTick;
+};
+
+template <class Handler>
+void
+TimingWheel::Advance(Handler inHandler)
+{
+	// at the start of each coarser slot's stretch its events move down
+	// the coarsest first, as some of them land in the next one down
+	uint32_t	levels = 1;
+
+	while (levels < kLevelCount && (mTick & ((1U << (kSlotBits * levels)) - 1)) == 0)
+		levels++;
+
+	for (uint32_t level = levels - 1; level > 0; level--)
+	{
+		for (uint16_t node = Take(level * kSlotCount + ((mTick >> (kSlotBits * level)) & kSlotMask)); node != kNoEvent; )
+		{
+			uint16_t	next = mNodes[node].mNext;
+
+			Insert(node);
+			node = next;
+		}
+	}
+
+	uint32_t	slot = mTick & kSlotMask;
+
+	mTick++;
+
+	Expire(slot, inHandler);
+}
+
+template <class Handler>
+void
+TimingWheel::Drain(Handler inHandler)
+{
+	for (uint32_t slot = 0; slot < kLevelCount * kSlotCount; slot++)
+		Expire(slot, inHandler);
+}
+
+// the slot's list goes aside first, so an event the handler schedules
+// a whole turn of the wheel away lands back in the slot and waits for it
+// then one at a time off the front, so the handler can cancel the rest
+template <class Handler>
+void
+TimingWheel::Expire(uint32_t inSlot, Handler inHandler)
+{
+	mSlots[kExpiringSlot] = Take(inSlot);
+
+	for (uint16_t node = mSlots[kExpiringSlot]; node != kNoEvent; node = mNodes[node].mNext)
+		mNodes[node].mSlot = kExpiringSlot;
+
+	while (mSlots[kExpiringSlot] != kNoEvent)
+	{
+		uint16_t		node = mSlots[kExpiringSlot];
+		TimedEvent	event = mNodes[node].mEvent;
+
+		Cancel(node);
+		inHandler(event);
+	}
+}
+
+#endif	// TimingWheel_h
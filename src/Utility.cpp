@@ -0,0 +1,27 @@
+// Utility.cpp
+
+// INCLUDES
+
+#include "Utility.h"
+
+
+
+bool Utility::SelectProbability(Random &inRandom, uint8_t inProbability)
+{
+	uint8_t	retval = 0;
+
+	if (inProbability == 0)
+	{
+		retval = false;
+	}
+	else if (inProbability == 100)
+	{
+		retval = true;
+	}
+	else
+	{
+		retval = inRandom.Below(100) < inProbability;
+	}
+
+	return retval;
+}
@@ -0,0 +1,63 @@
+// Utility.h
+
+// GUARD
+
+#ifndef Utility_h
+#define Utility_h
+
+// INCLUDES
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "Random.h"
+
+// CLASS
+
+class Utility
+{
+	public:
+
+		static bool
+		SelectProbability(Random &inRandom, uint8_t inProbability);
+
+		template<typename T> static
+		T SelectValue(Random &inRandom, const T &inLower, const T &inUpper);
+
+		static int
+		Clamp(int inValue, int inLower, int inUpper)
+		{
+			return inValue < inLower ? inLower : (inValue > inUpper ? inUpper : inValue);
+		}
+
+};
+
+template<typename T>
+T Utility::SelectValue(Random &inRandom, const T &inLower, const T &inUpper)
+{
+	T	retval = 0;
+
+// fprintf(stderr, "select value from %d to %d\n", inLower, inUpper);
+
+	if (inLower == inUpper)
+	{
+		retval = inLower;
+	}
+	else
+	{
+		int32_t	range = inUpper - inLower;
+		range = abs(range);
+
+		// Below() gives 0..range-1 so
+		range++;
+
+// fprintf(stderr, "range is %d\n", range);
+
+		T	roll = (T) inRandom.Below(range);
+		retval = inLower + roll;
+	}
+
+	return retval;
+}
+
+#endif	// Utility_h
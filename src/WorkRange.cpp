@@ -0,0 +1,45 @@
+// WorkRange.cpp
+
+// INCLUDES
+
+#include "WorkRange.h"
+
+void
+DealWork(std::vector<WorkRange> &outRanges, uint32_t inCount)
+{
+	uint32_t	workerCount = outRanges.size();
+
+	for (uint32_t workerNumber = 0; workerNumber < workerCount; workerNumber++)
+	{
+		outRanges[workerNumber].Set
+			((uint64_t) inCount * workerNumber / workerCount,
+			(uint64_t) inCount * (workerNumber + 1) / workerCount);
+	}
+}
+
+bool
+TakeWork(std::vector<WorkRange> &ioRanges, uint32_t inWorkerNumber, uint32_t &outNumber)
+{
+	while (!ioRanges[inWorkerNumber].Take(outNumber))
+	{
+		// start with the next one along
+		bool	stolen = false;
+
+		for (uint32_t offset = 1; offset < ioRanges.size() && !stolen; offset++)
+		{
+			uint32_t	begin = 0;
+			uint32_t	end = 0;
+
+			if (ioRanges[(inWorkerNumber + offset) % ioRanges.size()].Steal(begin, end))
+			{
+				ioRanges[inWorkerNumber].Set(begin, end);
+				stolen = true;
+			}
+		}
+
+		if (!stolen)
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,106 @@
+// WorkRange.h
+
+// GUARD
+
+#ifndef WorkRange_h
+#define WorkRange_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
+// CLASS
+
+// a range of job numbers in one atomic word
+// the owner takes from the front, idle workers steal the back half
+// numbers only ever move between ranges, so there's no ABA
+
+class WorkRange
+{
+	public:
+
+		WorkRange()
+			:
+			mRange(0)
+		{
+		}
+
+		void
+		Set(uint32_t inBegin, uint32_t inEnd)
+		{
+			mRange.store(Pack(inBegin, inEnd));
+		}
+
+		bool
+		Take(uint32_t &outNumber)
+		{
+			uint64_t	range = mRange.load();
+
+			for (;;)
+			{
+				uint32_t	begin = range >> 32;
+				uint32_t	end = (uint32_t) range;
+
+				if (begin >= end)
+					return false;
+
+				if (mRange.compare_exchange_weak(range, Pack(begin + 1, end)))
+				{
+					outNumber = begin;
+					return true;
+				}
+			}
+		}
+
+		bool
+		Steal(uint32_t &outBegin, uint32_t &outEnd)
+		{
+			uint64_t	range = mRange.load();
+
+			for (;;)
+			{
+				uint32_t	begin = range >> 32;
+				uint32_t	end = (uint32_t) range;
+
+				if (begin >= end)
+					return false;
+
+				// takes the last one too
+				uint32_t	middle = begin + (end - begin) / 2;
+
+				if (mRange.compare_exchange_weak(range, Pack(begin, middle)))
+				{
+					outBegin = middle;
+					outEnd = end;
+					return true;
+				}
+			}
+		}
+
+	private:
+
+		static uint64_t
+		Pack(uint32_t inBegin, uint32_t inEnd)
+		{
+			return ((uint64_t) inBegin << 32) | inEnd;
+		}
+
+		std::atomic<uint64_t>	mRange;
+
+		// keep neighbouring workers off each other's cache lines
+		char									mPadding[56];
+};
+
+// deals inCount jobs out evenly, stealing evens out the rest
+void
+DealWork(std::vector<WorkRange> &outRanges, uint32_t inCount);
+
+// the next job for a worker, stolen from the others if its own range is empty
+// false when there's nothing left anywhere
+bool
+TakeWork(std::vector<WorkRange> &ioRanges, uint32_t inWorkerNumber, uint32_t &outNumber);
+
+#endif	// WorkRange_h
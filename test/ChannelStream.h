@@ -0,0 +1,65 @@
+// ChannelStream.h
+
+// GUARD
+
+#ifndef ChannelStream_h
+#define ChannelStream_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <CoreMIDI/MIDIServices.h>
+
+#include "Random.h"
+
+// FUNCTIONS
+
+// MPE style pressure, bend and timbre over every channel with clock through it
+// at least inLength bytes, each message with its own status
+inline void
+MakeChannelStream(Random &ioRandom, uint32_t inLength, std::vector<Byte> &outBytes)
+{
+	while (outBytes.size() < inLength)
+	{
+		Byte	channel = ioRandom.Below(16);
+
+		switch (ioRandom.Below(4))
+		{
+			case 0:
+				outBytes.insert(outBytes.end(), { (Byte) (0xd0 | channel), (Byte) ioRandom.Below(128) });
+				break;
+
+			case 1:
+				outBytes.insert(outBytes.end(), { (Byte) (0xe0 | channel), (Byte) ioRandom.Below(128), (Byte) ioRandom.Below(128) });
+				break;
+
+			case 2:
+				outBytes.insert(outBytes.end(), { (Byte) (0xb0 | channel), 74, (Byte) ioRandom.Below(128) });
+				break;
+
+			case 3:
+				outBytes.push_back(0xf8);
+				break;
+		}
+	}
+}
+
+// what the channelising listener did a byte at a time, less its printf
+inline void
+RemapBytes(const Byte *inData, Byte *outData, uint32_t inLength, Byte inFrom, Byte inTo)
+{
+	for (uint32_t byteNumber = 0; byteNumber < inLength; byteNumber++)
+	{
+		Byte	byte = inData[byteNumber];
+
+		if (byte >= 0x80 && byte < 0xf0 && (byte & 0xf) == inFrom)
+			byte = (byte & 0xf0) | inTo;
+
+		outData[byteNumber] = byte;
+	}
+}
+
+#endif	// ChannelStream_h
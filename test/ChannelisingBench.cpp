@@ -0,0 +1,104 @@
+// ChannelisingBench.cpp
+
+// usage: ChannelisingBench [megabytes]
+// times remapping channels 16 bytes at a time against a byte at a time
+// on that much MPE style traffic, in packets of a few sizes
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// library headers
+
+#include <CoreMIDI/CoreMIDI.h>
+
+#include "MIDICLChannelisingListener.h"
+#include "MIDICLPacketListBuilder.h"
+
+// sequencer headers
+
+#include "Random.h"
+
+// test headers
+
+#include "ChannelStream.h"
+
+// a byte at a time against 16 at a time, in packets of each size
+static int
+MeasureChannelising(uint32_t inMegabytes)
+{
+	Random	random(1);
+
+	MIDICLChannelisingListener	listener(nullptr);
+
+	// 2 to 5 is nibble 1 to nibble 4
+	listener.SetFromChannel(2);
+	listener.SetToChannel(5);
+
+	for (uint32_t packetSize : { 16, 64, 256, 1024, 16384 })
+	{
+		std::vector<Byte>	bytes;
+
+		MakeChannelStream(random, 65536, bytes);
+
+		std::vector<uint32_t>		inputStorage(bytes.size() / 2 + 1024);
+		std::vector<uint32_t>		outputStorage(inputStorage.size());
+		MIDICLPacketListBuilder	input(nullptr, (Byte *) inputStorage.data(), inputStorage.size() * sizeof(uint32_t));
+		MIDICLPacketListBuilder	output(nullptr, (Byte *) outputStorage.data(), outputStorage.size() * sizeof(uint32_t));
+
+		// cut anywhere, it doesn't need whole messages
+		for (size_t offset = 0; offset < bytes.size(); offset += packetSize)
+			input.Add(0, bytes.data() + offset, std::min((size_t) packetSize, bytes.size() - offset));
+
+		uint32_t	runs = std::max((uint32_t) ((uint64_t) inMegabytes * 1000000 / bytes.size()), 1U);
+
+		std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+		for (uint32_t run = 0; run < runs; run++)
+		{
+			output.Clear();
+
+			const MIDIPacket	*packet = input.GetPacketList()->packet;
+
+			for (UInt32 packetNumber = 0; packetNumber < input.GetPacketList()->numPackets;
+				packetNumber++, packet = MIDIPacketNext(packet))
+			{
+				RemapBytes(packet->data, output.Reserve(packet->length), packet->length, 1, 4);
+				output.Commit(0, packet->length);
+			}
+		}
+
+		std::chrono::duration<double>	bytewise(std::chrono::steady_clock::now() - start);
+
+		start = std::chrono::steady_clock::now();
+
+		for (uint32_t run = 0; run < runs; run++)
+		{
+			output.Clear();
+			listener.Run(input.GetPacketList(), output);
+		}
+
+		std::chrono::duration<double>	vector(std::chrono::steady_clock::now() - start);
+
+		double	megabytes = (double) runs * bytes.size() / 1000000.0;
+
+		printf("%5u byte packets, a byte at a time %.0f MB/s, 16 at a time %.0f MB/s, %.1fx\n", packetSize,
+			megabytes / bytewise.count(), megabytes / vector.count(), bytewise.count() / vector.count());
+	}
+
+	return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	megabytes = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 100;
+
+	return MeasureChannelising(megabytes);
+}
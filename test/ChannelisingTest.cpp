@@ -0,0 +1,98 @@
+// ChannelisingTest.cpp
+
+// usage: ChannelisingTest
+// checks the channelising listener's 16 at a time remapping
+// makes what a byte at a time did, cut into packets of every size from 1 to 64 and some bigger
+
+// system headers
+
+#include <stdio.h>
+
+// language headers
+
+#include <algorithm>
+#include <vector>
+
+// library headers
+
+#include <CoreMIDI/CoreMIDI.h>
+
+#include "MIDICLChannelisingListener.h"
+#include "MIDICLPacketListBuilder.h"
+
+// sequencer headers
+
+#include "Random.h"
+
+// test headers
+
+#include "ChannelStream.h"
+
+// returns how many packet sizes came out wrongly
+static uint32_t
+CheckChannelising()
+{
+	Random		random(1);
+	uint32_t	failures = 0;
+
+	MIDICLChannelisingListener	listener(nullptr);
+
+	// 2 to 5 is nibble 1 to nibble 4
+	listener.SetFromChannel(2);
+	listener.SetToChannel(5);
+
+	std::vector<uint32_t>	packetSizes;
+
+	// either side of the vector width and its multiples, then a few big ones
+	for (uint32_t packetSize = 1; packetSize <= 64; packetSize++)
+		packetSizes.push_back(packetSize);
+
+	packetSizes.insert(packetSizes.end(), { 255, 256, 257, 1024, 16384 });
+
+	for (uint32_t packetSize : packetSizes)
+	{
+		std::vector<Byte>	bytes;
+
+		MakeChannelStream(random, 4096 + random.Below(64), bytes);
+
+		// a one byte packet takes up to four words with its header
+		std::vector<uint32_t>		inputStorage(bytes.size() * 4 + 1024);
+		std::vector<uint32_t>		outputStorage(inputStorage.size());
+		MIDICLPacketListBuilder	input(nullptr, (Byte *) inputStorage.data(), inputStorage.size() * sizeof(uint32_t));
+		MIDICLPacketListBuilder	output(nullptr, (Byte *) outputStorage.data(), outputStorage.size() * sizeof(uint32_t));
+
+		// cut anywhere, it doesn't need whole messages
+		for (size_t offset = 0; offset < bytes.size(); offset += packetSize)
+			input.Add(0, bytes.data() + offset, std::min((size_t) packetSize, bytes.size() - offset));
+
+		std::vector<Byte>	expected(bytes.size());
+
+		RemapBytes(bytes.data(), expected.data(), bytes.size(), 1, 4);
+
+		listener.Run(input.GetPacketList(), output);
+
+		std::vector<Byte>	remapped;
+		const MIDIPacket	*packet = output.GetPacketList()->packet;
+
+		for (UInt32 packetNumber = 0; packetNumber < output.GetPacketList()->numPackets;
+			packetNumber++, packet = MIDIPacketNext(packet))
+		{
+			remapped.insert(remapped.end(), packet->data, packet->data + packet->length);
+		}
+
+		if (remapped != expected)
+		{
+			printf("%u byte packets remapped wrongly\n", packetSize);
+			failures++;
+		}
+	}
+
+	printf("%u of %u packet sizes remapped wrongly\n", failures, (uint32_t) packetSizes.size());
+
+	return failures;
+}
+
+int main(int argc, const char *argv[])
+{
+	return CheckChannelising() ? 1 : 0;
+}
@@ -0,0 +1,59 @@
+// ClockBench.cpp
+
+// usage: ClockBench [seconds]
+// plays the built in pattern into nothing for that long
+// and prints how late the clock thread woke against each tick's deadline
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// language headers
+
+#include <algorithm>
+#include <vector>
+
+// sequencer headers
+
+#include "Sequence.h"
+#include "Sequencer.h"
+#include "TickRecorder.h"
+
+// plays into nothing for inSeconds and reports how well the clock thread kept up
+// stamped, the clock only jitters on ticks that missed the lookahead
+static int
+MeasureClock(Sequencer &inSequencer, uint32_t inSeconds)
+{
+	TickRecorder	recorder((uint32_t) (inSeconds * inSequencer.GetBPM() / 60.0f * kTicksPerQuarterNote) + kTicksPerBar);
+
+	if (!inSequencer.Play(&recorder))
+	{
+		fprintf(stderr, "could not start sequencer\n");
+		return 1;
+	}
+
+	sleep(inSeconds);
+
+	inSequencer.Stop();
+
+	inSequencer.GetClockStats().Print();
+
+	printf("unstamped, the clock would have had %.3fms deviation\n", IntervalDeviation(recorder.GetTimes(), 0));
+
+	return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	seconds = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 2;
+
+	std::vector<Sequence>	sequences(1);
+	Sequencer							sequencer;
+
+	sequences[0].SetUpDefault();
+	sequencer.SetSequences(sequences);
+
+	return MeasureClock(sequencer, seconds);
+}
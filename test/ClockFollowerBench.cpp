@@ -0,0 +1,104 @@
+// ClockFollowerBench.cpp
+
+// usage: ClockFollowerBench [jitter ms]
+// plays the built in pattern to a clock with that much jitter on each pulse
+// and prints how steady the ticks came out against how steady the pulses went in
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <vector>
+
+// library headers
+
+#include <CoreMIDI/CoreMIDI.h>
+
+// sequencer headers
+
+#include "ClockFollower.h"
+#include "HostTime.h"
+#include "Random.h"
+#include "Sequence.h"
+#include "Sequencer.h"
+#include "TickRecorder.h"
+
+// hands a real time byte to the follower as if it came in on a port
+static void
+HearRealTime(ClockFollower &inFollower, Byte inByte, uint64_t inTime)
+{
+	MIDIPacketList	list;
+	MIDIPacket			*packet = MIDIPacketListInit(&list);
+
+	MIDIPacketListAdd(&list, sizeof(list), packet, HostTime::FromNanoseconds(inTime), 1, &inByte);
+
+	inFollower.Hear(&list);
+}
+
+// plays two bars of clock with up to inJitter ms either way on each pulse
+// into a follower standing in for an input port
+// and compares how steady the ticks come out with how steady the pulses went in
+static int
+MeasureFollowing(Sequencer &inSequencer, double inJitter)
+{
+	const uint32_t	pulseCount = kTicksPerBar * 2;
+	const double		period = 60000000000.0 / (inSequencer.GetBPM() * kTicksPerQuarterNote);
+	const uint32_t	jitter = (uint32_t) std::min(inJitter * 1000000.0, period / 2 - 1);
+
+	ClockFollower					follower;
+	TickRecorder					recorder(pulseCount);
+	Random								random(1);
+	std::vector<uint64_t>	pulseTimes;
+
+	if (!inSequencer.Follow(&recorder, &follower))
+	{
+		fprintf(stderr, "could not start following\n");
+		return 1;
+	}
+
+	uint64_t	start = HostTime::Now() + 10000000;
+
+	HearRealTime(follower, 0xfa, start - 1000000);
+
+	for (uint32_t pulse = 0; pulse < pulseCount; pulse++)
+	{
+		uint64_t	time = start + (uint64_t) (pulse * period) + random.Below(jitter * 2 + 1) - jitter;
+
+		HostTime::WaitUntil(time);
+		HearRealTime(follower, 0xf8, time);
+
+		pulseTimes.push_back(time);
+	}
+
+	HostTime::WaitUntil(HostTime::Now() + (uint64_t) period + kFollowLatency);
+	HearRealTime(follower, 0xfc, HostTime::Now());
+
+	inSequencer.Stop();
+
+	const std::vector<uint64_t>	&tickTimes(recorder.GetTimes());
+
+	// give the loop a beat to lock
+	printf("%u pulses in with %.3fms deviation, %u ticks out with %.3fms deviation, %u dropped\n",
+		pulseCount, IntervalDeviation(pulseTimes, kTicksPerQuarterNote),
+		(uint32_t) tickTimes.size(), IntervalDeviation(tickTimes, kTicksPerQuarterNote),
+		follower.GetDroppedCount());
+
+	return tickTimes.size() == pulseCount ? 0 : 1;
+}
+
+int main(int argc, const char *argv[])
+{
+	double	jitter = argc > 1 ? atof(argv[1]) : 1.0;
+
+	std::vector<Sequence>	sequences(1);
+	Sequencer							sequencer;
+
+	sequences[0].SetUpDefault();
+	sequencer.SetSequences(sequences);
+
+	return MeasureFollowing(sequencer, jitter);
+}
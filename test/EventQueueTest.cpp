@@ -0,0 +1,169 @@
+// EventQueueTest.cpp
+
+// usage: EventQueueTest [events]
+// plays that many events from each of several threads into one MIDICLEventQueue
+// paced like busy keyboards, then flat out, while this thread drains it the way the tick does
+// checks nothing goes missing without being counted as dropped or arrives out of order
+// and prints how long events took through the queue
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mach/mach_time.h>
+
+// language headers
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// library headers
+
+#include "MIDICLEventQueue.h"
+#include "MIDICLPacketListBuilder.h"
+#include "MIDICLQueueingListener.h"
+
+// sequencer headers
+
+#include "HostTime.h"
+
+// the ports that play into one queue at once
+static const uint32_t	kEventQueuePorts = 4;
+
+// each port sends inEvents note ons numbered in their key and velocity, inSpacing nanoseconds apart
+// while this thread drains the queue the way the tick does, only flat out
+// returns how many arrived out of order or went missing without being counted as dropped
+static uint32_t
+RunEventQueue(uint32_t inEvents, uint64_t inSpacing, std::vector<uint32_t> &outLatencies, uint32_t &outDropped)
+{
+	MIDICLEventQueue	queue(1024);
+
+	std::vector<std::unique_ptr<MIDICLQueueingListener> >	listeners;
+	std::vector<std::thread>	ports;
+	std::atomic<uint32_t>			running(kEventQueuePorts);
+
+	for (uint32_t port = 0; port < kEventQueuePorts; port++)
+		listeners.emplace_back(new MIDICLQueueingListener(&queue, port));
+
+	for (uint32_t port = 0; port < kEventQueuePorts; port++)
+	{
+		ports.emplace_back([&, port] ()
+		{
+			UInt32									storage[16];
+			MIDICLPacketListBuilder	builder(nullptr, (Byte *) storage, sizeof(storage));
+			uint64_t								due = HostTime::Now();
+
+			for (uint32_t event = 0; event < inEvents; event++)
+			{
+				Byte	bytes[] = { (Byte) (0x90 | port), (Byte) (event & 0x7f), (Byte) ((event >> 7) & 0x7f) };
+
+				// yielding rather than sleeping, which would be the latency we're measuring
+				while (inSpacing && HostTime::Now() < due)
+					std::this_thread::yield();
+
+				due += inSpacing;
+
+				builder.Clear();
+				builder.Add(mach_absolute_time(), bytes, sizeof(bytes));
+
+				listeners[port]->Hear(builder.GetPacketList());
+			}
+
+			running--;
+		});
+	}
+
+	uint32_t	received[kEventQueuePorts] = { };
+	uint32_t	failures = 0;
+
+	auto	hear = [&] (const MIDICLEventQueue::Event &inEvent)
+	{
+		uint64_t	sent = HostTime::ToNanoseconds(inEvent.mMessage.mTimeStamp);
+		uint32_t	port = inEvent.mSource;
+		uint32_t	number = inEvent.mMessage.mData[0] | (inEvent.mMessage.mData[1] << 7);
+
+		outLatencies.push_back(HostTime::Now() - sent);
+
+		// one port's events stay in order, with gaps only where some were dropped
+		if (((number - received[port]) & 0x3fff) > queue.GetDroppedCount(port))
+			failures++;
+
+		received[port] = number + 1;
+	};
+
+	// with nothing there the ports get the core, in case there's only one
+	while (running > 0)
+	{
+		if (queue.Drain(hear) == 0)
+			std::this_thread::yield();
+	}
+
+	queue.Drain(hear);
+
+	for (std::thread &port : ports)
+		port.join();
+
+	outDropped = queue.GetDroppedCount();
+
+	if (outLatencies.size() + outDropped != (size_t) inEvents * kEventQueuePorts)
+		failures++;
+
+	return failures;
+}
+
+static void
+PrintLatencies(const char *inName, std::vector<uint32_t> &ioLatencies, uint32_t inDropped, double inSeconds)
+{
+	if (ioLatencies.empty())
+		return;
+
+	std::sort(ioLatencies.begin(), ioLatencies.end());
+
+	size_t	count = ioLatencies.size();
+
+	printf("%s %zu events in %.3fs, %u dropped, latency median %.2fus 99%% %.2fus 99.9%% %.2fus worst %.2fus\n",
+		inName, count, inSeconds, inDropped, ioLatencies[count / 2] / 1000.0, ioLatencies[count * 99 / 100] / 1000.0,
+		ioLatencies[count * 999 / 1000] / 1000.0, ioLatencies.back() / 1000.0);
+}
+
+static int
+MeasureEventQueue(uint32_t inEvents)
+{
+	uint32_t	failures = 0;
+
+	// a busy keyboard on each port, about a message every 100us between them
+	// then as fast as the ports can go, which a queue of 1024 can't keep up with for long
+	uint64_t		spacings[] = { 400000, 0 };
+	const char	*names[] = { "paced", "flat out" };
+
+	for (uint32_t run = 0; run < 2; run++)
+	{
+		std::vector<uint32_t>	latencies;
+		uint32_t							dropped = 0;
+
+		latencies.reserve((size_t) inEvents * kEventQueuePorts);
+
+		std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+		failures += RunEventQueue(run == 0 ? std::min(inEvents, 2500U) : inEvents, spacings[run], latencies, dropped);
+
+		std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
+
+		PrintLatencies(names[run], latencies, dropped, elapsed.count());
+	}
+
+	printf("%u ports, %u events lost or out of order\n", kEventQueuePorts, failures);
+
+	return failures ? 1 : 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	events = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 100000;
+
+	return MeasureEventQueue(events);
+}
@@ -0,0 +1,66 @@
+// FilterSets.h
+
+// GUARD
+
+#ifndef FilterSets_h
+#define FilterSets_h
+
+// INCLUDES
+
+#include "MIDICLMessage.h"
+#include "MIDICLMessageFilter.h"
+
+// FILTER SETS
+
+// each as a MIDICLMessageFilter and as the branches it replaces
+
+// notes on channel 1
+typedef MIDICLMessageFilter<0x0001, 0x03>	ChannelOneNotes;
+
+struct ChannelOneNotesBranches
+{
+	static bool
+	Passes(const MIDICLMessage &inMessage)
+	{
+		return (inMessage.mStatus == 0x80 || inMessage.mStatus == 0x90);
+	}
+};
+
+// the left hand of a split across the first four channels, aftertouch and all
+typedef MIDICLMessageFilter<0x000f, 0x07, 36, 59>	LeftHand;
+
+struct LeftHandBranches
+{
+	static bool
+	Passes(const MIDICLMessage &inMessage)
+	{
+		return inMessage.mStatus >= 0x80 && inMessage.mStatus < 0xb0 && (inMessage.mStatus & 0xf) < 4
+			&& inMessage.mData[0] >= 36 && inMessage.mData[0] <= 59;
+	}
+};
+
+// mod wheel and sustain on any channel
+typedef MIDICLMessageFilter<0xffff, 0x08, 0, 127, 1ULL << 1, 1ULL << 0>	WheelAndPedal;
+
+struct WheelAndPedalBranches
+{
+	static bool
+	Passes(const MIDICLMessage &inMessage)
+	{
+		return (inMessage.mStatus & 0xf0) == 0xb0 && (inMessage.mData[0] == 1 || inMessage.mData[0] == 64);
+	}
+};
+
+// everything but system messages
+typedef MIDICLMessageFilter<0xffff, 0x7f>	NoSystem;
+
+struct NoSystemBranches
+{
+	static bool
+	Passes(const MIDICLMessage &inMessage)
+	{
+		return inMessage.mStatus >= 0x80 && inMessage.mStatus < 0xf0;
+	}
+};
+
+#endif	// FilterSets_h
@@ -0,0 +1,156 @@
+// ListenerSetTest.cpp
+
+// usage: ListenerSetTest [lists]
+// one thread hears that many packet lists through a MIDICLListenerSet flat out
+// while another adds and removes listeners at random
+// checks no listener hears a list once it's been removed or gets a copy of one
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// library headers
+
+#include "MIDICLInputPortListener.h"
+#include "MIDICLListenerSet.h"
+#include "MIDICLPacketListBuilder.h"
+
+// sequencer headers
+
+#include "Random.h"
+
+// counts what it hears, and anything it hears while it's meant to be out of the set
+class ListenerProbe
+	:
+	public MIDICLInputPortListener
+{
+	public:
+
+		ListenerProbe(const MIDIPacketList *inList)
+			:
+			mList(inList),
+			mAttached(false),
+			mHeard(0),
+			mLate(0),
+			mCopies(0)
+		{
+		}
+
+		void
+		Hear(const MIDIPacketList *inList)
+		{
+			if (!mAttached.load(std::memory_order_relaxed))
+				mLate++;
+
+			// everyone gets the port's own list
+			if (inList != mList)
+				mCopies++;
+
+			mHeard++;
+		}
+
+		const MIDIPacketList		*mList;
+
+		std::atomic<bool>				mAttached;
+		std::atomic<uint32_t>		mHeard;
+		std::atomic<uint32_t>		mLate;
+		std::atomic<uint32_t>		mCopies;
+};
+
+// one thread hears inLists packet lists as fast as it can
+// while this one adds and removes listeners at random
+static int
+MeasureListenerSet(uint32_t inLists)
+{
+	static const uint32_t	kProbeCount = 8;
+
+	UInt32									storage[16];
+	MIDICLPacketListBuilder	builder(nullptr, (Byte *) storage, sizeof(storage));
+	Byte										bytes[] = { 0x90, 60, 100 };
+
+	builder.Add(0, bytes, sizeof(bytes));
+
+	MIDICLListenerSet	set;
+
+	std::vector<std::unique_ptr<ListenerProbe> >	probes;
+
+	for (uint32_t probe = 0; probe < kProbeCount; probe++)
+		probes.emplace_back(new ListenerProbe(builder.GetPacketList()));
+
+	std::atomic<bool>	hearing(true);
+	double						seconds = 0;
+
+	std::thread	port([&] ()
+	{
+		std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+		for (uint32_t list = 0; list < inLists; list++)
+			set.Hear(builder.GetPacketList());
+
+		std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
+
+		seconds = elapsed.count();
+		hearing = false;
+	});
+
+	Random		random(1);
+	uint32_t	changes = 0;
+
+	while (hearing)
+	{
+		ListenerProbe	*probe = probes[random.Below(kProbeCount)].get();
+
+		// attached just before it goes in, so it's never heard while it isn't
+		// and detached only once it's out, which is when it can't be heard any more
+		if (probe->mAttached)
+		{
+			set.Remove(probe);
+			probe->mAttached = false;
+		}
+		else
+		{
+			probe->mAttached = true;
+			set.Add(probe);
+		}
+
+		changes++;
+
+		std::this_thread::yield();
+	}
+
+	port.join();
+
+	uint32_t	heard = 0;
+	uint32_t	late = 0;
+	uint32_t	copies = 0;
+
+	for (std::unique_ptr<ListenerProbe> &probe : probes)
+	{
+		heard += probe->mHeard;
+		late += probe->mLate;
+		copies += probe->mCopies;
+	}
+
+	printf("%u lists heard %u times in %.3fs (%.0fns a list) across %u adds and removes\n",
+		inLists, heard, seconds, seconds * 1e9 / inLists, changes);
+	printf("%u heard after their removal, %u given a copy\n", late, copies);
+
+	return late || copies ? 1 : 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	lists = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 1000000;
+
+	return MeasureListenerSet(lists);
+}
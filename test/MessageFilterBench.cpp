@@ -0,0 +1,144 @@
+// MessageFilterBench.cpp
+
+// usage: MessageFilterBench [messages]
+// times compile time filters against the branches they replace
+// on a random mix of that many messages, and one of them as a listener
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// library headers
+
+#include "MIDICLFilteringListener.h"
+#include "MIDICLMessage.h"
+#include "MIDICLMessageWriter.h"
+#include "MIDICLPacketListBuilder.h"
+#include "MIDICLParser.h"
+
+// sequencer headers
+
+#include "Random.h"
+
+// test headers
+
+#include "FilterSets.h"
+
+// nanoseconds a message, and how many passed
+template <class F> static double
+TimeFilter(const std::vector<MIDICLMessage> &inMessages, uint32_t inRuns, uint32_t &outPassed)
+{
+	uint32_t	passed = 0;
+
+	std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+	// read through a volatile each run, so the compiler can't work out one run and multiply
+	const MIDICLMessage	*volatile	messages = inMessages.data();
+
+	for (uint32_t run = 0; run < inRuns; run++)
+	{
+		const MIDICLMessage	*runMessages = messages;
+
+		for (size_t messageNumber = 0; messageNumber < inMessages.size(); messageNumber++)
+			passed += F::Passes(runMessages[messageNumber]);
+	}
+
+	outPassed = passed / inRuns;
+
+	std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
+
+	return elapsed.count() * 1e9 / ((double) inRuns * inMessages.size());
+}
+
+// times the two against each other
+template <class F, class B> static void
+MeasureFilter(const char *inName, const std::vector<MIDICLMessage> &inMessages, uint32_t inRuns)
+{
+	uint32_t	tablePassed = 0;
+	uint32_t	branchesPassed = 0;
+	double		table = TimeFilter<F>(inMessages, inRuns, tablePassed);
+	double		branches = TimeFilter<B>(inMessages, inRuns, branchesPassed);
+
+	// both counts printed, so neither loop can be thrown away
+	printf("%-16s of %u, tables pass %u in %.2fns a message, branches %u in %.2fns\n",
+		inName, (uint32_t) inMessages.size(), tablePassed, table, branchesPassed, branches);
+}
+
+// a random mix of everything, mostly notes and controllers with a little clock
+static int
+MeasureFilters(uint32_t inMessages)
+{
+	Random											random(1);
+	std::vector<MIDICLMessage>	messages(inMessages);
+
+	for (MIDICLMessage &message : messages)
+	{
+		uint32_t	kind = random.Below(16);
+
+		if (kind < 6)
+			message.mStatus = 0x80 + random.Below(32);
+		else if (kind < 11)
+			message.mStatus = 0xb0 + random.Below(16);
+		else if (kind < 14)
+			message.mStatus = 0xa0 + random.Below(16) + 0x10 * random.Below(4);
+		else
+			message.mStatus = 0xf8;
+
+		message.mTimeStamp = 0;
+		message.mData[0] = random.Below(128);
+		message.mData[1] = random.Below(128);
+		message.mDataLength = MIDICLParser::kByteClasses[message.mStatus] & MIDICLParser::kDataLengthMask;
+	}
+
+	uint32_t	runs = std::max(100000000 / inMessages, 1U);
+
+	MeasureFilter<ChannelOneNotes, ChannelOneNotesBranches>("channel 1 notes", messages, runs);
+	MeasureFilter<LeftHand, LeftHandBranches>("left hand", messages, runs);
+	MeasureFilter<WheelAndPedal, WheelAndPedalBranches>("wheel and pedal", messages, runs);
+	MeasureFilter<NoSystem, NoSystemBranches>("no system", messages, runs);
+
+	// the same messages through the listener path, parsed and written back out
+	std::vector<uint32_t>		inputStorage(inMessages + 64);
+	std::vector<uint32_t>		outputStorage(inMessages + 64);
+	MIDICLPacketListBuilder	input(nullptr, (Byte *) inputStorage.data(), inputStorage.size() * sizeof(uint32_t));
+	MIDICLPacketListBuilder	output(nullptr, (Byte *) outputStorage.data(), outputStorage.size() * sizeof(uint32_t));
+
+	{
+		MIDICLMessageWriter	writer(input);
+
+		for (const MIDICLMessage &message : messages)
+			writer.Write(message);
+	}
+
+	MIDICLFilteringListener<LeftHand>	listener(nullptr);
+
+	runs = std::max(runs / 10, 1U);
+
+	std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+	for (uint32_t run = 0; run < runs; run++)
+	{
+		output.Clear();
+		listener.Run(input.GetPacketList(), output);
+	}
+
+	std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
+
+	printf("left hand as a listener, %.2fns a message\n", elapsed.count() * 1e9 / ((double) runs * inMessages));
+
+	return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	messages = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 4096;
+
+	return MeasureFilters(messages);
+}
@@ -0,0 +1,95 @@
+// MessageFilterTest.cpp
+
+// usage: MessageFilterTest
+// checks each compile time filter passes exactly what the branches it replaces do
+// for every status byte with every first data byte
+// and that sysex through a filtering listener goes where the filter sends system messages
+
+// system headers
+
+#include <stdio.h>
+
+// library headers
+
+#include "MIDICLFilteringListener.h"
+#include "MIDICLMessage.h"
+#include "MIDICLPacketListBuilder.h"
+#include "MIDICLParser.h"
+
+// test headers
+
+#include "FilterSets.h"
+
+// returns how many messages the two disagree on
+template <class F, class B> static uint32_t
+CheckFilter(const char *inName)
+{
+	uint32_t	passed = 0;
+	uint32_t	disagreements = 0;
+
+	for (uint32_t status = 0x80; status <= 0xff; status++)
+	{
+		for (uint32_t data = 0; data < 128; data++)
+		{
+			MIDICLMessage	message;
+
+			message.mTimeStamp = 0;
+			message.mStatus = status;
+			message.mData[0] = data;
+			message.mData[1] = 64;
+			message.mDataLength = MIDICLParser::kByteClasses[status] & MIDICLParser::kDataLengthMask;
+
+			passed += F::Passes(message);
+			disagreements += F::Passes(message) != B::Passes(message);
+		}
+	}
+
+	printf("%-16s %5u of %u pass, %u disagreements\n", inName, passed, 128 * 128, disagreements);
+
+	return disagreements;
+}
+
+// a note, sysex and a clock through a MIDICLFilteringListener<F>
+// returns 1 if the sysex doesn't pass exactly when F passes system messages
+template <class F> static uint32_t
+CheckSysEx(const char *inName, bool inPasses)
+{
+	static const Byte				kBytes[] = { 0x90, 60, 100, 0xf0, 0x7e, 0x7f, 0x06, 0x01, 0xf7, 0xf8 };
+	UInt32									inputStorage[64];
+	UInt32									outputStorage[64];
+	MIDICLPacketListBuilder	input(nullptr, (Byte *) inputStorage, sizeof(inputStorage));
+	MIDICLPacketListBuilder	output(nullptr, (Byte *) outputStorage, sizeof(outputStorage));
+	MIDICLFilteringListener<F>	listener(nullptr);
+
+	input.Add(0, kBytes, sizeof(kBytes));
+	listener.Run(input.GetPacketList(), output);
+
+	const MIDIPacketList	*list = output.GetPacketList();
+	const MIDIPacket			*packet = list->packet;
+	bool									passed = false;
+
+	for (UInt32 packetNumber = 0; packetNumber < list->numPackets; packetNumber++, packet = MIDIPacketNext(packet))
+	{
+		for (UInt16 i = 0; i < packet->length; i++)
+			passed |= packet->data[i] == 0xf0;
+	}
+
+	printf("%-16s sysex %s\n", inName, passed ? "passes" : "blocked");
+
+	return passed != inPasses;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	disagreements = 0;
+
+	disagreements += CheckFilter<ChannelOneNotes, ChannelOneNotesBranches>("channel 1 notes");
+	disagreements += CheckFilter<LeftHand, LeftHandBranches>("left hand");
+	disagreements += CheckFilter<WheelAndPedal, WheelAndPedalBranches>("wheel and pedal");
+	disagreements += CheckFilter<NoSystem, NoSystemBranches>("no system");
+
+	disagreements += CheckSysEx<MIDICLMessageFilter<> >("everything", true);
+	disagreements += CheckSysEx<NoSystem>("no system", false);
+
+	return disagreements ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+// MessageWriterTest.cpp
+
+// usage: MessageWriterTest
+// writes messages and sysex through a MIDICLMessageWriter with the time stamp changing between them
+// checks each packet comes out with the time stamp of what's in it, in running status where it can
+
+// system headers
+
+#include <stdio.h>
+#include <string.h>
+
+// language headers
+
+#include <initializer_list>
+
+// library headers
+
+#include <CoreMIDI/CoreMIDI.h>
+
+#include "MIDICLMessage.h"
+#include "MIDICLMessageWriter.h"
+#include "MIDICLPacketListBuilder.h"
+
+// a packet as it should come out
+struct Expected
+{
+	MIDITimeStamp									mTimeStamp;
+	std::initializer_list<Byte>		mBytes;
+};
+
+// the builder's packets against what they should be, false if they're not the same
+static bool
+CheckPackets(MIDICLPacketListBuilder &inBuilder, const char *inName, std::initializer_list<Expected> inExpected)
+{
+	const MIDIPacketList	*list = inBuilder.GetPacketList();
+	const MIDIPacket			*packet = list->packet;
+	bool									same = list->numPackets == inExpected.size();
+
+	for (UInt32 packetNumber = 0; same && packetNumber < list->numPackets; packetNumber++, packet = MIDIPacketNext(packet))
+	{
+		const Expected	&expected = inExpected.begin()[packetNumber];
+
+		same = packet->timeStamp == expected.mTimeStamp && packet->length == expected.mBytes.size()
+			&& memcmp(packet->data, expected.mBytes.begin(), packet->length) == 0;
+	}
+
+	if (same)
+		return true;
+
+	printf("%s came out as", inName);
+
+	packet = list->packet;
+
+	for (UInt32 packetNumber = 0; packetNumber < list->numPackets; packetNumber++, packet = MIDIPacketNext(packet))
+	{
+		printf(" %llu [", (unsigned long long) packet->timeStamp);
+
+		for (UInt16 i = 0; i < packet->length; i++)
+			printf(" %02x", packet->data[i]);
+
+		printf(" ]");
+	}
+
+	printf("\n");
+
+	return false;
+}
+
+static MIDICLMessage
+Message(MIDITimeStamp inTimeStamp, Byte inStatus, Byte inOne, Byte inTwo)
+{
+	MIDICLMessage	message;
+
+	message.mTimeStamp = inTimeStamp;
+	message.mStatus = inStatus;
+	message.mData[0] = inOne;
+	message.mData[1] = inTwo;
+	message.mDataLength = inStatus >= 0xf8 ? 0 : 2;
+
+	return message;
+}
+
+int main(int argc, const char *argv[])
+{
+	int	failures = 0;
+
+	// a chord at one time, then a clock and a note off later
+	{
+		UInt32									storage[64];
+		MIDICLPacketListBuilder	builder(nullptr, (Byte *) storage, sizeof(storage));
+
+		{
+			MIDICLMessageWriter	writer(builder);
+
+			writer.Write(Message(100, 0x90, 60, 100));
+			writer.Write(Message(100, 0x90, 64, 100));
+			writer.Write(Message(200, 0xf8, 0, 0));
+			writer.Write(Message(200, 0x90, 60, 0));
+		}
+
+		failures += !CheckPackets(builder, "chord then note off",
+			{ { 100, { 0x90, 60, 100, 64, 100 } }, { 200, { 0xf8, 0x90, 60, 0 } } });
+	}
+
+	// sysex between messages, each with its own time
+	{
+		UInt32									storage[64];
+		MIDICLPacketListBuilder	builder(nullptr, (Byte *) storage, sizeof(storage));
+		static const Byte				kSysEx[] = { 0xf0, 0x7e, 0x7f, 0xf7 };
+
+		{
+			MIDICLMessageWriter	writer(builder);
+
+			writer.Write(Message(100, 0xb0, 7, 100));
+			writer.WriteSysEx(kSysEx, sizeof(kSysEx), 150);
+			writer.Write(Message(200, 0xb0, 7, 90));
+		}
+
+		failures += !CheckPackets(builder, "sysex between messages",
+			{ { 100, { 0xb0, 7, 100 } }, { 150, { 0xf0, 0x7e, 0x7f, 0xf7 } }, { 200, { 0xb0, 7, 90 } } });
+	}
+
+	printf("%d failures\n", failures);
+
+	return failures > 0 ? 1 : 0;
+}
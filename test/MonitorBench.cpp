@@ -0,0 +1,161 @@
+// MonitorBench.cpp
+
+// usage: MonitorBench [lists]
+// times each Hear() printing as it goes, as MIDICLMonitor used to in the read proc,
+// against only copying into the monitor's ring
+// flat out for that many lists, then at what a USB cable can manage, with the text going nowhere
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <chrono>
+
+// library headers
+
+#include <CoreMIDI/CoreMIDI.h>
+
+#include "MIDICLInputPortListener.h"
+#include "MIDICLMonitor.h"
+#include "MIDICLPacketListBuilder.h"
+#include "MIDICLParser.h"
+
+// sequencer headers
+
+#include "HostTime.h"
+
+// what MIDICLMonitor used to do in the read proc, a line per message as it's heard
+class PrintingMonitor
+	:
+	public MIDICLInputPortListener
+{
+	public:
+
+		PrintingMonitor(FILE *outText)
+			:
+			mText(outText)
+		{
+		}
+
+		void
+		Hear(const MIDIPacketList *inList)
+		{
+			mParser.Parse(inList, *this);
+		}
+
+		void
+		Message(const MIDICLMessage &inMessage)
+		{
+			fprintf(mText, "%02x", inMessage.mStatus);
+
+			for (Byte i = 0; i < inMessage.mDataLength; i++)
+				fprintf(mText, " %02x", inMessage.mData[i]);
+
+			fprintf(mText, "\n");
+		}
+
+		void
+		SysEx(const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp)
+		{
+			for (UInt32 i = 0; i < inLength; i++)
+				fprintf(mText, "%02x ", inData[i]);
+
+			fprintf(mText, "\n");
+		}
+
+	private:
+
+		FILE					*mText;
+		MIDICLParser	mParser;
+};
+
+// the time each Hear() took, flat out then paced
+static int
+MeasureMonitor(uint32_t inFlatOutLists)
+{
+	// a packet of a chord and some pressure, another of clock
+	UInt32									storage[64];
+	MIDICLPacketListBuilder	builder(nullptr, (Byte *) storage, sizeof(storage));
+	Byte										chord[] = { 0x90, 60, 100, 64, 100, 67, 100, 0xd0, 80 };
+	Byte										clock[] = { 0xf8 };
+
+	builder.Add(1, chord, sizeof(chord));
+	builder.Add(2, clock, sizeof(clock));
+
+	const MIDIPacketList	*list = builder.GetPacketList();
+
+	FILE	*nowhere = fopen("/dev/null", "w");
+
+	if (nowhere == nullptr)
+		return 1;
+
+	PrintingMonitor	printing(nowhere);
+	MIDICLMonitor		monitor(nowhere);
+
+	MIDICLInputPortListener	*listeners[] = { &printing, &monitor };
+	const char							*names[] = { "printing", "ring" };
+	uint32_t								dropped = 0;
+
+	for (uint32_t listener = 0; listener < 2; listener++)
+	{
+		std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+		for (uint32_t listNumber = 0; listNumber < inFlatOutLists; listNumber++)
+			listeners[listener]->Hear(list);
+
+		std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
+
+		printf("flat out, %s %.0fns a list, %u packets dropped\n", names[listener], elapsed.count() * 1e9 / inFlatOutLists,
+			monitor.GetDroppedCount() - dropped);
+
+		dropped = monitor.GetDroppedCount();
+	}
+
+	// let the writer catch up before the paced run
+	monitor.Sync();
+
+	// USB full speed tops out at about 1000 of these lists a second
+	for (uint32_t listener = 0; listener < 2; listener++)
+	{
+		uint64_t	due = HostTime::Now();
+		uint64_t	worst = 0;
+		uint64_t	total = 0;
+
+		for (uint32_t listNumber = 0; listNumber < 1000; listNumber++)
+		{
+			HostTime::WaitUntil(due);
+			due += 1000000;
+
+			uint64_t	start = HostTime::Now();
+
+			listeners[listener]->Hear(list);
+
+			uint64_t	took = HostTime::Now() - start;
+
+			total += took;
+			worst = std::max(worst, took);
+		}
+
+		printf("paced, %s %.0fns a list, worst %.0fns, %u packets dropped\n", names[listener], total / 1000.0,
+			(double) worst, monitor.GetDroppedCount() - dropped);
+
+		dropped = monitor.GetDroppedCount();
+	}
+
+	monitor.Sync();
+
+	fclose(nowhere);
+
+	return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	lists = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 200000;
+
+	return MeasureMonitor(lists);
+}
@@ -0,0 +1,245 @@
+// MonitorTest.cpp
+
+// usage: MonitorTest [capture]
+// hears lists flat out, then paced, then from several ports at once through a MIDICLMonitor
+// capturing to capture.0 and on, /tmp/MonitorTest.0 and on by default
+// checks every packet was either captured whole or counted as dropped
+// and that one too big for a capture segment is counted as dropped
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// language headers
+
+#include <thread>
+#include <vector>
+
+// library headers
+
+#include <CoreMIDI/CoreMIDI.h>
+
+#include "MIDICLCaptureFile.h"
+#include "MIDICLMonitor.h"
+#include "MIDICLPacketListBuilder.h"
+
+// sequencer headers
+
+#include "HostTime.h"
+#include "MappedFile.h"
+
+// a packet of a chord and some pressure, another of clock
+static const Byte	kChord[] = { 0x90, 60, 100, 64, 100, 67, 100, 0xd0, 80 };
+static const Byte	kClock[] = { 0xf8 };
+
+// how many packets and data bytes the segments of a capture hold
+// false if one's damaged or has a packet in it that was never sent
+static bool
+ReadCapture(const char *inPath, uint32_t inSegmentCount, uint64_t &outPackets, uint64_t &outBytes)
+{
+	outPackets = 0;
+	outBytes = 0;
+
+	for (uint32_t segment = 0; segment < inSegmentCount; segment++)
+	{
+		char	path[1024];
+
+		snprintf(path, sizeof(path), "%s.%u", inPath, segment);
+
+		MappedFile	file;
+
+		// not every segment need have been got to
+		if (!file.Open(path))
+			continue;
+
+		const MIDICLCaptureFile::Header	*header = (const MIDICLCaptureFile::Header *) file.GetData();
+
+		if (file.GetLength() < sizeof(*header) || memcmp(header->mMagic, "MCAP", 4) != 0
+			|| sizeof(*header) + header->mLength > file.GetLength())
+		{
+			return false;
+		}
+
+		const Byte	*record = file.GetData() + sizeof(*header);
+		const Byte	*end = record + header->mLength;
+
+		while (record < end)
+		{
+			UInt16	length;
+
+			memcpy(&length, record + sizeof(MIDITimeStamp), sizeof(length));
+
+			const Byte	*data = record + MIDICLCaptureFile::kRecordHeaderSize;
+
+			record += MIDICLCaptureFile::kRecordHeaderSize + length;
+
+			if (record > end || !((length == sizeof(kChord) && memcmp(data, kChord, length) == 0)
+				|| (length == sizeof(kClock) && memcmp(data, kClock, length) == 0)))
+			{
+				return false;
+			}
+
+			outPackets++;
+			outBytes += length;
+		}
+
+		if (record != end)
+			return false;
+	}
+
+	return true;
+}
+
+// what an earlier run left, which would otherwise be counted as captured
+static void
+RemoveCapture(const char *inPath, uint32_t inSegmentCount)
+{
+	for (uint32_t segment = 0; segment < inSegmentCount; segment++)
+	{
+		char	path[1024];
+
+		snprintf(path, sizeof(path), "%s.%u", inPath, segment);
+		unlink(path);
+	}
+}
+
+// false if a packet went missing, neither captured nor dropped
+static bool
+CheckMonitor(const char *inCapturePath)
+{
+	UInt32									storage[64];
+	MIDICLPacketListBuilder	builder(nullptr, (Byte *) storage, sizeof(storage));
+
+	builder.Add(1, kChord, sizeof(kChord));
+	builder.Add(2, kClock, sizeof(kClock));
+
+	const MIDIPacketList	*list = builder.GetPacketList();
+
+	static const uint32_t	kSegmentSize = 1 << 20;
+	static const uint32_t	kSegmentCount = 64;
+	static const uint32_t	kFlatOutLists = 200000;
+	static const uint32_t	kPacedLists = 1000;
+	static const uint32_t	kPortCount = 4;
+	static const uint32_t	kPortLists = 50000;
+
+	MIDICLMonitor	monitor(nullptr);
+
+	RemoveCapture(inCapturePath, kSegmentCount);
+
+	if (!monitor.Capture(inCapturePath, kSegmentSize, kSegmentCount))
+	{
+		fprintf(stderr, "could not capture to %s\n", inCapturePath);
+		return false;
+	}
+
+	// flat out, when the ring can fill
+	for (uint32_t listNumber = 0; listNumber < kFlatOutLists; listNumber++)
+		monitor.Hear(list);
+
+	monitor.Sync();
+
+	// at what a USB cable can manage, when it shouldn't
+	uint64_t	due = HostTime::Now();
+	uint32_t	dropped = monitor.GetDroppedCount();
+
+	for (uint32_t listNumber = 0; listNumber < kPacedLists; listNumber++)
+	{
+		HostTime::WaitUntil(due);
+		due += 1000000;
+
+		monitor.Hear(list);
+	}
+
+	monitor.Sync();
+
+	uint32_t	pacedDropped = monitor.GetDroppedCount() - dropped;
+
+	// as if from several input ports, each calling Hear() on a thread of its own
+	std::vector<std::thread>	ports;
+
+	for (uint32_t port = 0; port < kPortCount; port++)
+	{
+		ports.emplace_back([&monitor, list]()
+		{
+			for (uint32_t listNumber = 0; listNumber < kPortLists; listNumber++)
+				monitor.Hear(list);
+		});
+	}
+
+	for (std::thread &port : ports)
+		port.join();
+
+	monitor.Sync();
+	monitor.StopCapture();
+
+	uint64_t	packets = 0;
+	uint64_t	bytes = 0;
+	uint64_t	heard = (kFlatOutLists + kPacedLists + kPortCount * kPortLists) * 2;
+
+	if (!ReadCapture(inCapturePath, kSegmentCount, packets, bytes))
+	{
+		fprintf(stderr, "capture %s is damaged\n", inCapturePath);
+		return false;
+	}
+
+	printf("captured %llu of %llu packets with %u dropped, %u of them paced, %llu bytes\n", (unsigned long long) packets,
+		(unsigned long long) heard, monitor.GetDroppedCount(), pacedDropped, (unsigned long long) bytes);
+
+	return packets + monitor.GetDroppedCount() == heard;
+}
+
+// false if a packet too big for a segment isn't counted as dropped
+static bool
+CheckOversize(const char *inCapturePath)
+{
+	UInt32									storage[64];
+	MIDICLPacketListBuilder	builder(nullptr, (Byte *) storage, sizeof(storage));
+	Byte										sysEx[64];
+
+	memset(sysEx, 0, sizeof(sysEx));
+	sysEx[0] = 0xf0;
+	sysEx[sizeof(sysEx) - 1] = 0xf7;
+
+	builder.Add(1, sysEx, sizeof(sysEx));
+	builder.Add(2, kClock, sizeof(kClock));
+
+	MIDICLMonitor	monitor(nullptr);
+
+	// room for the clock but not the sysex
+	if (!monitor.Capture(inCapturePath, sizeof(MIDICLCaptureFile::Header) + 32, 1))
+	{
+		fprintf(stderr, "could not capture to %s\n", inCapturePath);
+		return false;
+	}
+
+	monitor.Hear(builder.GetPacketList());
+	monitor.Sync();
+	monitor.StopCapture();
+
+	uint64_t	packets = 0;
+	uint64_t	bytes = 0;
+
+	if (!ReadCapture(inCapturePath, 1, packets, bytes))
+	{
+		fprintf(stderr, "capture %s is damaged\n", inCapturePath);
+		return false;
+	}
+
+	printf("captured %llu of 2 packets with %u too big\n", (unsigned long long) packets, monitor.GetDroppedCount());
+
+	return packets == 1 && monitor.GetDroppedCount() == 1;
+}
+
+int main(int argc, const char *argv[])
+{
+	const char	*capturePath = argc > 1 ? argv[1] : "/tmp/MonitorTest";
+
+	bool	passed = CheckMonitor(capturePath);
+
+	passed = CheckOversize(capturePath) && passed;
+
+	return passed ? 0 : 1;
+}
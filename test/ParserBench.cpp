@@ -0,0 +1,94 @@
+// ParserBench.cpp
+
+// usage: ParserBench [megabytes]
+// parses that much of a random stream in packet sized pieces and prints how fast
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// library headers
+
+#include "MIDICLParser.h"
+
+// sequencer headers
+
+#include "Random.h"
+
+// test headers
+
+#include "ParserStream.h"
+
+// just counts, so the parser's the only cost
+class ParsedCounter
+{
+	public:
+
+		ParsedCounter()
+			:
+			mCount(0)
+		{
+		}
+
+		void
+		Message(const MIDICLMessage &inMessage)
+		{
+			mCount++;
+		}
+
+		void
+		SysEx(const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp)
+		{
+			mCount++;
+		}
+
+		uint64_t	mCount;
+};
+
+// times the parser on a random stream
+static int
+MeasureParser(uint32_t inMegabytes)
+{
+	Random	random(1);
+
+	std::vector<Byte>	stream;
+	std::vector<Byte>	expected;
+
+	MakeParserStream(random, 1 << 18, stream, expected);
+
+	ParsedCounter	counter;
+	MIDICLParser	parser;
+	uint64_t			bytes = 0;
+
+	std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+	// in packet sized pieces
+	while (bytes < (uint64_t) inMegabytes * 1000000)
+	{
+		for (size_t offset = 0; offset < stream.size(); offset += 256)
+			parser.Parse(stream.data() + offset, std::min((size_t) 256, stream.size() - offset), 0, counter);
+
+		bytes += stream.size();
+	}
+
+	std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
+
+	printf("parsed %.1fMB into %llu messages in %.3fs (%.0f MB/s)\n", bytes / 1000000.0,
+		(unsigned long long) counter.mCount, elapsed.count(), bytes / elapsed.count() / 1000000.0);
+
+	return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	megabytes = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 100;
+
+	return MeasureParser(megabytes);
+}
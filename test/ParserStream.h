@@ -0,0 +1,101 @@
+// ParserStream.h
+
+// GUARD
+
+#ifndef ParserStream_h
+#define ParserStream_h
+
+// INCLUDES
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <CoreMIDI/MIDIServices.h>
+
+#include "Random.h"
+
+// FUNCTIONS
+
+// a stream of inMessages random messages and what parsing it should make
+// with running status where it can, sysex, system common and clocks in the middle of things
+inline void
+MakeParserStream(Random &ioRandom, uint32_t inMessages, std::vector<Byte> &outStream, std::vector<Byte> &outExpected)
+{
+	Byte	runningStatus = 0;
+
+	for (uint32_t messageNumber = 0; messageNumber < inMessages; messageNumber++)
+	{
+		uint32_t					kind = ioRandom.Below(20);
+		std::vector<Byte>	message;
+
+		if (kind == 0)
+		{
+			message.push_back(0xf0);
+
+			for (uint32_t length = ioRandom.Below(300); length > 0; length--)
+				message.push_back(ioRandom.Below(128));
+
+			message.push_back(0xf7);
+			runningStatus = 0;
+		}
+		else if (kind == 1)
+		{
+			static const Byte	kCommon[] = { 0xf1, 0xf2, 0xf3, 0xf6 };
+			static const Byte	kLengths[] = { 1, 2, 1, 0 };
+
+			uint32_t	common = ioRandom.Below(4);
+
+			message.push_back(kCommon[common]);
+
+			for (Byte length = kLengths[common]; length > 0; length--)
+				message.push_back(ioRandom.Below(128));
+
+			runningStatus = 0;
+		}
+		else
+		{
+			Byte	status = 0x80 + ioRandom.Below(7) * 0x10 + ioRandom.Below(16);
+
+			message.push_back(status);
+			message.push_back(ioRandom.Below(128));
+
+			if (status < 0xc0 || status >= 0xe0)
+				message.push_back(ioRandom.Below(128));
+		}
+
+		bool			clock = ioRandom.Below(4) == 0;
+		uint32_t	clockAt = 1 + ioRandom.Below(message.size());
+
+		// the parser hands on a clock in the middle of a message before the message
+		// but sysex comes out in pieces either side of it
+		uint32_t	expectedClockAt = clockAt < message.size() && message[0] != 0xf0 ? 0 : clockAt;
+
+		for (uint32_t byte = 0; byte <= message.size(); byte++)
+		{
+			if (clock && byte == expectedClockAt)
+				outExpected.push_back(0xf8);
+
+			if (byte < message.size())
+				outExpected.push_back(message[byte]);
+		}
+
+		bool	running = message[0] < 0xf0 && message[0] == runningStatus && ioRandom.Below(2) == 0;
+
+		for (uint32_t byte = running ? 1 : 0; byte < message.size(); byte++)
+		{
+			if (clock && byte == clockAt)
+				outStream.push_back(0xf8);
+
+			outStream.push_back(message[byte]);
+		}
+
+		if (clock && clockAt == message.size())
+			outStream.push_back(0xf8);
+
+		if (message[0] < 0xf0)
+			runningStatus = message[0];
+	}
+}
+
+#endif	// ParserStream_h
@@ -0,0 +1,114 @@
+// ParserTest.cpp
+
+// usage: ParserTest [trials]
+// parses random streams in random pieces, as CoreMIDI might hand them over
+// and checks they come out as the messages they were made from
+// and that noise comes out the same however it's split
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <vector>
+
+// library headers
+
+#include "MIDICLParser.h"
+
+// sequencer headers
+
+#include "Random.h"
+
+// test headers
+
+#include "ParserStream.h"
+
+// what a parser made, back in bytes with running status spelled out
+// sysex pieces run back together, so it's the same however the stream was split
+class ParsedBytes
+{
+	public:
+
+		void
+		Message(const MIDICLMessage &inMessage)
+		{
+			mBytes.push_back(inMessage.mStatus);
+			mBytes.insert(mBytes.end(), inMessage.mData, inMessage.mData + inMessage.mDataLength);
+		}
+
+		void
+		SysEx(const Byte *inData, UInt32 inLength, MIDITimeStamp inTimeStamp)
+		{
+			mBytes.insert(mBytes.end(), inData, inData + inLength);
+		}
+
+		std::vector<Byte>	mBytes;
+};
+
+// parses inStream in random pieces, as CoreMIDI might hand it over
+static void
+ParseInPieces(Random &ioRandom, const std::vector<Byte> &inStream, ParsedBytes &ioParsed)
+{
+	MIDICLParser	parser;
+
+	for (size_t offset = 0; offset < inStream.size(); )
+	{
+		size_t	length = std::min((size_t) 1 + ioRandom.Below(64), inStream.size() - offset);
+
+		parser.Parse(inStream.data() + offset, length, 0, ioParsed);
+		offset += length;
+	}
+}
+
+// returns how many of the 2 * inTrials streams parsed wrongly
+static uint32_t
+CheckParser(uint32_t inTrials)
+{
+	Random		random(1);
+	uint32_t	failures = 0;
+
+	for (uint32_t trial = 0; trial < inTrials; trial++)
+	{
+		// made from known messages, it should come back to them
+		std::vector<Byte>	stream;
+		std::vector<Byte>	expected;
+		ParsedBytes				parsed;
+
+		MakeParserStream(random, 1 + random.Below(200), stream, expected);
+		ParseInPieces(random, stream, parsed);
+
+		if (parsed.mBytes != expected)
+			failures++;
+
+		// any old bytes, which it should make the same of however they're split
+		std::vector<Byte>	noise(random.Below(2000));
+		ParsedBytes				whole;
+		ParsedBytes				pieces;
+		MIDICLParser			parser;
+
+		for (Byte &byte : noise)
+			byte = random.Below(256);
+
+		parser.Parse(noise.data(), noise.size(), 0, whole);
+		ParseInPieces(random, noise, pieces);
+
+		if (whole.mBytes != pieces.mBytes)
+			failures++;
+	}
+
+	return failures;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	trials = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 1000;
+	uint32_t	failures = CheckParser(trials);
+
+	printf("%u of %u random streams parsed wrongly\n", failures, trials * 2);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+// PatternBankTest.cpp
+
+// usage: PatternBankTest [patterns]
+// writes that many patterns of random note options to a bank and loads them back
+// checks every stored field comes back as it went in, gates over 127% included
+// and that a bank with a pattern damaged doesn't load
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// language headers
+
+#include <algorithm>
+#include <vector>
+
+// sequencer headers
+
+#include "PatternBank.h"
+#include "Random.h"
+#include "Sequence.h"
+#include "Step.h"
+
+// every field the bank keeps, anywhere in its range
+static void
+Randomise(NoteOption &outOption, Random &ioRandom)
+{
+	outOption.mProbability = ioRandom.Below(101);
+	outOption.mNoteLower = ioRandom.Below(128);
+	outOption.mNoteUpper = ioRandom.Below(128);
+	outOption.mVelocityLower = ioRandom.Below(128);
+	outOption.mVelocityUpper = ioRandom.Below(128);
+	outOption.mGateTimeLower = (int16_t) (ioRandom.Below(2000) - 1000);
+	outOption.mGateTimeUpper = (int16_t) ioRandom.Below(INT16_MAX + 1u);
+	outOption.mRatchetProbability = ioRandom.Below(101);
+	outOption.mMuteProbability = ioRandom.Below(101);
+	outOption.mTieProbability = ioRandom.Below(101);
+	outOption.mRatchetCount = 1 + ioRandom.Below(16);
+	outOption.mRatchetSpacing = 1 + ioRandom.Below(24);
+	outOption.mRatchetDecay = ioRandom.Below(101);
+	outOption.mInversionLower = ioRandom.Below(25);
+	outOption.mInversionUpper = ioRandom.Below(25);
+	outOption.mVoicingLower = ioRandom.Below(128);
+	outOption.mVoicingUpper = ioRandom.Below(128);
+	outOption.mChordIntervals = ioRandom.Next() & 0x1ffffff;
+}
+
+// how many fields of inLoaded differ from inWritten
+static uint32_t
+CountDifferences(const NoteOption &inWritten, const NoteOption &inLoaded)
+{
+	return (inWritten.mProbability != inLoaded.mProbability)
+		+ (inWritten.mNoteLower != inLoaded.mNoteLower)
+		+ (inWritten.mNoteUpper != inLoaded.mNoteUpper)
+		+ (inWritten.mVelocityLower != inLoaded.mVelocityLower)
+		+ (inWritten.mVelocityUpper != inLoaded.mVelocityUpper)
+		+ (inWritten.mGateTimeLower != inLoaded.mGateTimeLower)
+		+ (inWritten.mGateTimeUpper != inLoaded.mGateTimeUpper)
+		+ (inWritten.mRatchetProbability != inLoaded.mRatchetProbability)
+		+ (inWritten.mMuteProbability != inLoaded.mMuteProbability)
+		+ (inWritten.mTieProbability != inLoaded.mTieProbability)
+		+ (inWritten.mRatchetCount != inLoaded.mRatchetCount)
+		+ (inWritten.mRatchetSpacing != inLoaded.mRatchetSpacing)
+		+ (inWritten.mRatchetDecay != inLoaded.mRatchetDecay)
+		+ (inWritten.mInversionLower != inLoaded.mInversionLower)
+		+ (inWritten.mInversionUpper != inLoaded.mInversionUpper)
+		+ (inWritten.mVoicingLower != inLoaded.mVoicingLower)
+		+ (inWritten.mVoicingUpper != inLoaded.mVoicingUpper)
+		+ (inWritten.mChordIntervals != inLoaded.mChordIntervals);
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	patternCount = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 1000;
+
+	char	path[] = "/tmp/PatternBankTest.XXXXXX";
+	int		file = mkstemp(path);
+
+	if (file < 0)
+	{
+		perror(path);
+		return 1;
+	}
+
+	close(file);
+
+	std::vector<Sequence>	written(patternCount);
+	Random								random(1);
+
+	for (Sequence &sequence : written)
+	{
+		for (uint32_t stepNumber = 0; stepNumber < kBankStepCount; stepNumber++)
+		{
+			for (uint32_t optionNumber = 0; optionNumber < kBankNoteOptionCount; optionNumber++)
+				Randomise(sequence.GetStep(stepNumber).GetNoteOption(optionNumber), random);
+		}
+	}
+
+	std::vector<Sequence>	loaded;
+	PatternBank						bank;
+
+	if (!PatternBank::Write(path, written) || !bank.Open(path) || !bank.LoadAll(loaded))
+	{
+		printf("couldn't write and load %s\n", path);
+		unlink(path);
+		return 1;
+	}
+
+	uint32_t	differences = loaded.size() != written.size();
+
+	for (uint32_t patternNumber = 0; patternNumber < loaded.size() && patternNumber < written.size(); patternNumber++)
+	{
+		for (uint32_t stepNumber = 0; stepNumber < kBankStepCount; stepNumber++)
+		{
+			for (uint32_t optionNumber = 0; optionNumber < kBankNoteOptionCount; optionNumber++)
+			{
+				differences += CountDifferences(written[patternNumber].GetStep(stepNumber).GetNoteOption(optionNumber),
+					loaded[patternNumber].GetStep(stepNumber).GetNoteOption(optionNumber));
+			}
+		}
+	}
+
+	// a byte of the last pattern changed where it lies on disk
+	FILE	*damaged = fopen(path, "r+b");
+	bool	damagedLoads = true;
+
+	if (damaged && fseek(damaged, -1, SEEK_END) == 0 && fputc(0x55, damaged) != EOF && fclose(damaged) == 0)
+	{
+		PatternBank	damagedBank;
+
+		damagedLoads = damagedBank.Open(path) && damagedBank.LoadAll(loaded);
+	}
+
+	unlink(path);
+
+	printf("%u patterns loaded back with %u fields different, a damaged bank %s\n",
+		patternCount, differences, damagedLoads ? "loaded anyway" : "didn't load");
+
+	return differences == 0 && !damagedLoads ? 0 : 1;
+}
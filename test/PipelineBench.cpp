@@ -0,0 +1,219 @@
+// PipelineBench.cpp
+
+// usage: PipelineBench [packets]
+// times a four stage MIDICLPipeline against the same stages as chained listeners
+// and as one batch listener, and checks all three come out the same
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// language headers
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// library headers
+
+#include <CoreMIDI/CoreMIDI.h>
+
+#include "MIDICLBatchProcessingListener.h"
+#include "MIDICLPacketListBuilder.h"
+#include "MIDICLPipeline.h"
+#include "MIDICLQuantisingListener.h"
+#include "MIDICLScaleQuantiser.h"
+
+// the pipeline's four stages written out as a batch listener
+// just the way MeasurePipeline() sets them up
+class BatchStages
+	:
+	public MIDICLBatchProcessingListener<BatchStages>
+{
+	public:
+
+		BatchStages(const MIDICLScaleQuantiser &inQuantiser)
+			:
+			MIDICLBatchProcessingListener<BatchStages>(nullptr),
+			mQuantiser(inQuantiser)
+		{
+		}
+
+		void
+		Process(const MIDICLMessage *inMessages, UInt32 inCount, MIDICLMessageWriter &ioWriter)
+		{
+			for (UInt32 messageNumber = 0; messageNumber < inCount; messageNumber++)
+			{
+				MIDICLMessage	message = inMessages[messageNumber];
+
+				if (message.mStatus < 0xf0)
+				{
+					Byte	type = message.mStatus & 0xf0;
+					Byte	channel = message.mStatus & 0xf;
+
+					if (channel > 2)
+						continue;
+
+					if (channel == 1)
+						message.mStatus = type | 5;
+
+					if (type <= 0xa0)
+					{
+						int	key = message.mData[0] + 3;
+
+						message.mData[0] = mQuantiser.Quantise(key > 127 ? key - 12 : key);
+					}
+				}
+
+				ioWriter.Write(message);
+			}
+		}
+
+	private:
+
+		const MIDICLScaleQuantiser	&mQuantiser;
+};
+
+// a four stage pipeline against the same four stages as a chain of listeners
+// and as one batch listener
+// each listener in the chain copies the whole list on to the next
+// nothing is sent, so it's only the work on the lists that's timed
+static int
+MeasurePipeline(uint32_t inPackets)
+{
+	// a chord on and off per packet, on four channels, in running status
+	std::vector<uint32_t>	listStorage(inPackets * 8 + 64);
+	MIDICLPacketListBuilder	input(nullptr, (Byte *) listStorage.data(), listStorage.size() * sizeof(uint32_t));
+
+	for (uint32_t packet = 0; packet < inPackets; packet++)
+	{
+		Byte	key = 36 + packet % 48;
+		Byte	bytes[] = { (Byte) (0x90 | (packet % 4)), key, 100, (Byte) (key + 4), 100, key, 0, (Byte) (key + 4), 0 };
+
+		input.Add(0, bytes, sizeof(bytes));
+	}
+
+	UInt16	major = 0;
+
+	MIDICLScaleQuantiser::GetNamedScale("major", &major);
+
+	// the chain, the last of it the listener -thru uses
+	MIDICLPipeline	filter(nullptr);
+	MIDICLPipeline	remap(nullptr);
+	MIDICLPipeline	transpose(nullptr);
+
+	MIDICLScaleQuantiser			quantiser;
+	MIDICLQuantisingListener	quantise(nullptr, &quantiser);
+
+	filter.SetFilter(0x7, 0xff);
+	remap.SetChannelMap(1, 5);
+	transpose.SetTranspose(3);
+	quantiser.SetScale(major, 0);
+
+	// all of it in one
+	MIDICLPipeline	pipeline(nullptr);
+
+	pipeline.SetFilter(0x7, 0xff);
+	pipeline.SetChannelMap(1, 5);
+	pipeline.SetTranspose(3);
+	pipeline.SetScale(major, 0);
+
+	BatchStages	batch(quantiser);
+
+	std::vector<std::vector<uint32_t> >	stageStorage(6, listStorage);
+	std::vector<std::unique_ptr<MIDICLPacketListBuilder> >	outputs;
+
+	for (std::vector<uint32_t> &storage : stageStorage)
+	{
+		outputs.emplace_back(new MIDICLPacketListBuilder
+			(nullptr, (Byte *) storage.data(), storage.size() * sizeof(uint32_t)));
+	}
+
+	uint32_t	runs = std::max(1000000 / inPackets, 1U);
+
+	std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+	for (uint32_t run = 0; run < runs; run++)
+	{
+		outputs[0]->Clear();
+		filter.Run(input.GetPacketList(), *outputs[0]);
+
+		outputs[1]->Clear();
+		remap.Run(outputs[0]->GetPacketList(), *outputs[1]);
+
+		outputs[2]->Clear();
+		transpose.Run(outputs[1]->GetPacketList(), *outputs[2]);
+
+		outputs[3]->Clear();
+
+		const MIDIPacketList	*list = outputs[2]->GetPacketList();
+		const MIDIPacket			*packet = list->packet;
+
+		for (UInt32 packetNumber = 0; packetNumber < list->numPackets; packetNumber++, packet = MIDIPacketNext(packet))
+			outputs[3]->Commit(0, quantise.Process(packet, outputs[3]->Reserve(packet->length)));
+	}
+
+	std::chrono::duration<double>	chained(std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+
+	for (uint32_t run = 0; run < runs; run++)
+	{
+		outputs[4]->Clear();
+		pipeline.Run(input.GetPacketList(), *outputs[4]);
+	}
+
+	std::chrono::duration<double>	fused(std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+
+	for (uint32_t run = 0; run < runs; run++)
+	{
+		outputs[5]->Clear();
+		batch.Run(input.GetPacketList(), *outputs[5]);
+	}
+
+	std::chrono::duration<double>	batched(std::chrono::steady_clock::now() - start);
+
+	// all of them should have come out the same
+	bool	same = true;
+
+	for (uint32_t output = 4; output <= 5; output++)
+	{
+		const MIDIPacketList	*chainedList = outputs[3]->GetPacketList();
+		const MIDIPacketList	*otherList = outputs[output]->GetPacketList();
+		const MIDIPacket			*chainedPacket = chainedList->packet;
+		const MIDIPacket			*otherPacket = otherList->packet;
+
+		same = same && chainedList->numPackets == otherList->numPackets;
+
+		for (UInt32 packetNumber = 0; same && packetNumber < chainedList->numPackets; packetNumber++)
+		{
+			same = chainedPacket->length == otherPacket->length
+				&& memcmp(chainedPacket->data, otherPacket->data, chainedPacket->length) == 0;
+
+			chainedPacket = MIDIPacketNext(chainedPacket);
+			otherPacket = MIDIPacketNext(otherPacket);
+		}
+	}
+
+	double	packets = (double) runs * inPackets;
+
+	printf("%u packets, %u runs\n", inPackets, runs);
+	printf("chained listeners  %7.1f ns/packet\n", chained.count() * 1000000000.0 / packets);
+	printf("pipeline           %7.1f ns/packet\n", fused.count() * 1000000000.0 / packets);
+	printf("batch listener     %7.1f ns/packet\n", batched.count() * 1000000000.0 / packets);
+	printf("output %s\n", same ? "matches" : "DIFFERS");
+
+	return same ? 0 : 1;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	packets = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 1000;
+
+	return MeasurePipeline(packets);
+}
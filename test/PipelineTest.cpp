@@ -0,0 +1,252 @@
+// PipelineTest.cpp
+
+// usage: PipelineTest
+// sends notes through a MIDICLPipeline, changing the filter, channel map and transpose
+// between each note on and its note off, and splitting notes over packets
+// checks each note off goes to the channel and key its note on went to
+// that other channel messages in running status get their status again in the next packet
+// that a packet too long to grow by half comes out whole, in pieces of whole messages
+// and that the stages can be turned from another thread while packets go through
+
+// system headers
+
+#include <stdio.h>
+#include <string.h>
+
+// language headers
+
+#include <atomic>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+// library headers
+
+#include <CoreMIDI/CoreMIDI.h>
+
+#include "MIDICLPacketListBuilder.h"
+#include "MIDICLPipeline.h"
+
+// one packet through the pipeline, false if it didn't come out as expected
+// an empty expectation is no packet at all
+static bool
+CheckPacket(MIDICLPipeline &inPipeline, const char *inName,
+	std::initializer_list<Byte> inBytes, std::initializer_list<Byte> inExpected)
+{
+	UInt32									inputStorage[64];
+	UInt32									outputStorage[64];
+	MIDICLPacketListBuilder	input(nullptr, (Byte *) inputStorage, sizeof(inputStorage));
+	MIDICLPacketListBuilder	output(nullptr, (Byte *) outputStorage, sizeof(outputStorage));
+
+	input.Add(0, inBytes.begin(), inBytes.size());
+	inPipeline.Run(input.GetPacketList(), output);
+
+	const MIDIPacketList	*list = output.GetPacketList();
+
+	if (inExpected.size() == 0 ? list->numPackets == 0
+		: list->numPackets == 1 && list->packet[0].length == inExpected.size()
+			&& memcmp(list->packet[0].data, inExpected.begin(), inExpected.size()) == 0)
+	{
+		return true;
+	}
+
+	printf("%s came out as", inName);
+
+	const MIDIPacket	*packet = list->packet;
+
+	for (UInt32 packetNumber = 0; packetNumber < list->numPackets; packetNumber++, packet = MIDIPacketNext(packet))
+	{
+		printf(" [");
+
+		for (UInt16 i = 0; i < packet->length; i++)
+			printf(" %02x", packet->data[i]);
+
+		printf(" ]");
+	}
+
+	printf("\n");
+
+	return false;
+}
+
+// a sysex packet as long as they come, false if it doesn't come out the same
+static bool
+CheckLongPacket()
+{
+	std::vector<Byte>	sysEx(0xffff, 0x55);
+
+	sysEx.front() = 0xf0;
+	sysEx.back() = 0xf7;
+
+	// room for each piece as long as it could grow, so nothing gets flushed
+	std::vector<UInt32>			inputStorage(sysEx.size() / 4 + 64);
+	std::vector<UInt32>			outputStorage(sysEx.size() * 2 / 4 + 64);
+	MIDICLPacketListBuilder	input(nullptr, (Byte *) inputStorage.data(), inputStorage.size() * sizeof(UInt32));
+	MIDICLPacketListBuilder	output(nullptr, (Byte *) outputStorage.data(), outputStorage.size() * sizeof(UInt32));
+	MIDICLPipeline					pipeline(nullptr);
+
+	input.Add(0, sysEx.data(), sysEx.size());
+	pipeline.Run(input.GetPacketList(), output);
+
+	const MIDIPacketList	*list = output.GetPacketList();
+	const MIDIPacket			*packet = list->packet;
+	std::vector<Byte>			bytes;
+
+	for (UInt32 packetNumber = 0; packetNumber < list->numPackets; packetNumber++, packet = MIDIPacketNext(packet))
+		bytes.insert(bytes.end(), packet->data, packet->data + packet->length);
+
+	if (bytes == sysEx)
+		return true;
+
+	printf("long sysex came out as %u bytes in %u packets\n", (unsigned) bytes.size(), (unsigned) list->numPackets);
+
+	return false;
+}
+
+// control changes in running status as long as a packet comes, false unless each piece
+// starts with the status and holds whole messages that add up to what went in
+static bool
+CheckLongRunningStatus()
+{
+	std::vector<Byte>	controls(1, 0xb0);
+
+	while (controls.size() + 2 <= 0xffff)
+	{
+		controls.push_back(7);
+		controls.push_back(controls.size() & 0x7f);
+	}
+
+	std::vector<UInt32>			inputStorage(controls.size() / 4 + 64);
+	std::vector<UInt32>			outputStorage(controls.size() * 2 / 4 + 64);
+	MIDICLPacketListBuilder	input(nullptr, (Byte *) inputStorage.data(), inputStorage.size() * sizeof(UInt32));
+	MIDICLPacketListBuilder	output(nullptr, (Byte *) outputStorage.data(), outputStorage.size() * sizeof(UInt32));
+	MIDICLPipeline					pipeline(nullptr);
+
+	input.Add(0, controls.data(), controls.size());
+	pipeline.Run(input.GetPacketList(), output);
+
+	const MIDIPacketList	*list = output.GetPacketList();
+	const MIDIPacket			*packet = list->packet;
+	std::vector<Byte>			bytes(1, 0xb0);
+	bool									whole = true;
+
+	for (UInt32 packetNumber = 0; packetNumber < list->numPackets; packetNumber++, packet = MIDIPacketNext(packet))
+	{
+		whole = whole && packet->length % 2 == 1 && packet->data[0] == 0xb0;
+		bytes.insert(bytes.end(), packet->data + 1, packet->data + packet->length);
+	}
+
+	if (whole && list->numPackets > 1 && bytes == controls)
+		return true;
+
+	printf("long running status came out as %u bytes in %u packets%s\n", (unsigned) bytes.size(),
+		(unsigned) list->numPackets, whole ? "" : ", not all whole");
+
+	return false;
+}
+
+// transposes over and over on another thread while notes go through
+// false unless every one comes out as a whole note on or off
+static bool
+CheckTurningTranspose()
+{
+	MIDICLPipeline		pipeline(nullptr);
+	std::atomic<bool>	done(false);
+
+	std::thread	turner([&pipeline, &done]
+	{
+		for (int turn = 0; !done; turn++)
+			pipeline.SetTranspose(turn % 25 - 12);
+	});
+
+	uint32_t	malformed = 0;
+
+	for (uint32_t note = 0; note < 100000; note++)
+	{
+		UInt32									inputStorage[64];
+		UInt32									outputStorage[64];
+		MIDICLPacketListBuilder	input(nullptr, (Byte *) inputStorage, sizeof(inputStorage));
+		MIDICLPacketListBuilder	output(nullptr, (Byte *) outputStorage, sizeof(outputStorage));
+		Byte										bytes[] = { 0x90, (Byte) (note & 0x7f), (Byte) (note & 1 ? 0 : 100) };
+
+		input.Add(0, bytes, sizeof(bytes));
+		pipeline.Run(input.GetPacketList(), output);
+
+		const MIDIPacketList	*list = output.GetPacketList();
+
+		malformed += list->numPackets != 1 || list->packet[0].length != 3 || list->packet[0].data[0] != 0x90;
+	}
+
+	done = true;
+	turner.join();
+
+	if (malformed == 0)
+		return true;
+
+	printf("%u of 100000 notes came out malformed while transposing\n", malformed);
+
+	return false;
+}
+
+int main(int argc, const char *argv[])
+{
+	MIDICLPipeline	pipeline(nullptr);
+	int							failures = 0;
+
+	// remapped and transposed between on and off
+	failures += !CheckPacket(pipeline, "note on", { 0x90, 60, 100 }, { 0x90, 60, 100 });
+
+	pipeline.SetChannelMap(0, 3);
+	pipeline.SetTranspose(5);
+
+	failures += !CheckPacket(pipeline, "remapped note off", { 0x80, 60, 0 }, { 0x80, 60, 0 });
+	failures += !CheckPacket(pipeline, "remapped note on", { 0x90, 60, 100 }, { 0x93, 65, 100 });
+
+	// in running status, one of them sounding from before the map went back
+	pipeline.SetChannelMap(0, 0);
+
+	failures += !CheckPacket(pipeline, "running status", { 0x90, 62, 100, 60, 0, 62, 0 },
+		{ 0x90, 67, 100, 0x93, 65, 0, 0x90, 67, 0 });
+
+	// filtered out between on and off
+	failures += !CheckPacket(pipeline, "note on before the filter", { 0x91, 60, 100 }, { 0x91, 65, 100 });
+
+	pipeline.SetFilter(0xfffd, 0xff);
+
+	failures += !CheckPacket(pipeline, "pressure past the filter", { 0xa1, 60, 50 }, {});
+	failures += !CheckPacket(pipeline, "note off past the filter", { 0x91, 60, 0 }, { 0x91, 65, 0 });
+	failures += !CheckPacket(pipeline, "filtered note on", { 0x91, 60, 100 }, {});
+	failures += !CheckPacket(pipeline, "filtered note off", { 0x81, 60, 0 }, {});
+
+	// the key in one packet and the velocity in the next, with clock between
+	failures += !CheckPacket(pipeline, "split note on key", { 0x90, 60, 0xf8 }, { 0xf8 });
+	failures += !CheckPacket(pipeline, "split note on velocity", { 100 }, { 0x90, 65, 100 });
+
+	pipeline.SetTranspose(0);
+
+	failures += !CheckPacket(pipeline, "split note off key", { 0x80, 60 }, {});
+	failures += !CheckPacket(pipeline, "split note off velocity", { 0 }, { 0x80, 65, 0 });
+
+	// and nothing's left sounding
+	failures += !CheckPacket(pipeline, "untransposed note off", { 0x80, 60, 0 }, { 0x80, 60, 0 });
+
+	// running status into the next packet
+	pipeline.SetChannelMap(0, 3);
+
+	failures += !CheckPacket(pipeline, "control change", { 0xb0, 7, 100 }, { 0xb3, 7, 100 });
+	failures += !CheckPacket(pipeline, "running control change", { 7, 101 }, { 0xb3, 7, 101 });
+	failures += !CheckPacket(pipeline, "pitch bend", { 0xe0, 0, 64 }, { 0xe3, 0, 64 });
+	failures += !CheckPacket(pipeline, "running pitch bend", { 1, 65 }, { 0xe3, 1, 65 });
+	failures += !CheckPacket(pipeline, "program change", { 0xc0, 5, 6 }, { 0xc3, 5, 6 });
+	failures += !CheckPacket(pipeline, "running program change", { 7 }, { 0xc3, 7 });
+
+	pipeline.SetChannelMap(0, 0);
+
+	failures += !CheckLongPacket();
+	failures += !CheckLongRunningStatus();
+	failures += !CheckTurningTranspose();
+
+	printf("%d failures\n", failures);
+
+	return failures > 0 ? 1 : 0;
+}
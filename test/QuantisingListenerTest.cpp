@@ -0,0 +1,91 @@
+// QuantisingListenerTest.cpp
+
+// usage: QuantisingListenerTest
+// sends notes through a MIDICLQuantisingListener with clock between their bytes
+// and split over packets, transposing between each note on and its note off
+// checks the note off goes to the key its note on went to
+
+// system headers
+
+#include <stdio.h>
+#include <string.h>
+
+// language headers
+
+#include <initializer_list>
+#include <vector>
+
+// library headers
+
+#include <CoreMIDI/CoreMIDI.h>
+
+#include "MIDICLQuantisingListener.h"
+#include "MIDICLScaleQuantiser.h"
+
+// one packet through the listener, false if it didn't come out as expected
+static bool
+CheckPacket(MIDICLQuantisingListener &inListener, const char *inName,
+	std::initializer_list<Byte> inBytes, std::initializer_list<Byte> inExpected)
+{
+	MIDIPacket	packet;
+	Byte				output[sizeof(packet.data)];
+
+	packet.timeStamp = 0;
+	packet.length = inBytes.size();
+	memcpy(packet.data, inBytes.begin(), inBytes.size());
+
+	UInt16	length = inListener.Process(&packet, output);
+
+	if (length == inExpected.size() && memcmp(output, inExpected.begin(), length) == 0)
+		return true;
+
+	printf("%s came out as", inName);
+
+	for (UInt16 i = 0; i < length; i++)
+		printf(" %02x", output[i]);
+
+	printf("\n");
+
+	return false;
+}
+
+int main(int argc, const char *argv[])
+{
+	MIDICLScaleQuantiser	quantiser;
+	UInt16								scale = 0;
+
+	MIDICLScaleQuantiser::GetNamedScale("major", &scale);
+	quantiser.SetScale(scale, 0);
+
+	// C sharp, off the scale
+	Byte	key = 0x3d;
+	Byte	on = quantiser.Quantise(key);
+
+	MIDICLQuantisingListener	listener(nullptr, &quantiser);
+	int												failures = 0;
+
+	// clock between key and velocity, in one packet
+	failures += !CheckPacket(listener, "note on with clock", { 0x90, key, 0xf8, 0x64 }, { 0x90, on, 0xf8, 0x64 });
+
+	quantiser.SetTranspose(12);
+
+	failures += !CheckPacket(listener, "note off with clock", { 0x80, key, 0xf8, 0x00 }, { 0x80, on, 0xf8, 0x00 });
+
+	quantiser.SetTranspose(0);
+
+	// the key in one packet, its velocity in the next
+	failures += !CheckPacket(listener, "split note on key", { 0x90, key }, { 0x90, on });
+	failures += !CheckPacket(listener, "split note on velocity", { 0x64 }, { 0x64 });
+
+	quantiser.SetTranspose(12);
+
+	// a note on of no velocity, by running status
+	failures += !CheckPacket(listener, "note off by velocity", { key, 0xf8, 0x00 }, { on, 0xf8, 0x00 });
+
+	// and nothing's left sounding, so the next note on is transposed
+	failures += !CheckPacket(listener, "transposed note on", { 0x90, key, 0x64 }, { 0x90, quantiser.Quantise(key), 0x64 });
+
+	printf("%d failures\n", failures);
+
+	return failures > 0 ? 1 : 0;
+}
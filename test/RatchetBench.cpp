@@ -0,0 +1,117 @@
+// RatchetBench.cpp
+
+// usage: RatchetBench [loops]
+// renders that many loops of patterns with more and more ratchets into a counter
+// and prints what a tick and each event cost
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// sequencer headers
+
+#include "Sequence.h"
+#include "Sequencer.h"
+#include "SequencerOutput.h"
+
+// only counts what it's sent
+class EventCounter
+	:
+	public SequencerOutput
+{
+	public:
+
+		EventCounter()
+			:
+			mCount(0)
+		{
+		}
+
+		void
+		SendNoteOn(Byte inChannel, Byte inKey, Byte inVelocity)
+		{
+			mCount++;
+		}
+
+		void
+		SendNoteOff(Byte inChannel, Byte inKey, Byte inVelocity)
+		{
+			mCount++;
+		}
+
+		uint64_t
+		GetCount() const
+		{
+			return mCount;
+		}
+
+	private:
+
+		uint64_t	mCount;
+};
+
+// what a tick costs as more steps ratchet and with more hits
+// the cost of each event should stay the same however many there are
+static int
+MeasureRatchets(uint32_t inLoops)
+{
+	printf("ratchets  hits  ns/tick  events/tick  ns/event\n");
+
+	for (uint32_t probability : { 0, 25, 50, 100 })
+	{
+		for (uint32_t count : { 2, 4, 8, 16 })
+		{
+			std::vector<Sequence>	sequences(1);
+
+			for (uint32_t stepNumber = 0; stepNumber < sequences[0].GetStepCount(); stepNumber++)
+			{
+				Step	&step(sequences[0].GetStep(stepNumber));
+
+				step.GetNoteOption(0).mNoteLower = 40;
+				step.GetNoteOption(0).mNoteUpper = 60;
+				step.GetNoteOption(0).mRatchetProbability = probability;
+				step.GetNoteOption(0).mRatchetCount = count;
+				step.GetNoteOption(0).mRatchetSpacing = std::max(kTicksPerStep / count, 1U);
+				step.GetNoteOption(0).mRatchetDecay = 10;
+				step.GetNoteOption(1).mProbability = 0;
+			}
+
+			Sequencer			sequencer;
+			EventCounter	counter;
+			uint32_t			ticks = inLoops * sequences[0].GetStepCount() * kTicksPerStep;
+
+			sequencer.SetSequences(sequences);
+
+			std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+			sequencer.Render(&counter, ticks);
+
+			std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
+
+			double	nanoseconds = elapsed.count() * 1000000000.0;
+
+			printf("%7u%%  %4u  %7.1f  %11.2f  %8.1f\n", probability, count, nanoseconds / ticks,
+				(double) counter.GetCount() / ticks, nanoseconds / std::max(counter.GetCount(), (uint64_t) 1));
+
+			// nothing ratchets at all, so the hits don't matter
+			if (probability == 0)
+				break;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	loops = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 1000;
+
+	return MeasureRatchets(loops);
+}
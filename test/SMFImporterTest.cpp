@@ -0,0 +1,88 @@
+// SMFImporterTest.cpp
+
+// usage: SMFImporterTest
+// writes a two track file where both tracks hit the first step in the same take
+// and imports it, checking the step's chance counts that take once
+
+// system headers
+
+#include <stdio.h>
+#include <unistd.h>
+
+// sequencer headers
+
+#include "SMFImporter.h"
+#include "SMFWriter.h"
+#include "Sequence.h"
+#include "Step.h"
+
+static const uint32_t	kStepTicks = 12;
+static const uint32_t	kLoopTicks = kStepTicks * 16;
+
+// a quaver of inKey inTicks after the last thing in the track
+static void
+WriteNote(SMFWriter &ioWriter, uint32_t inTicks, Byte inKey)
+{
+	for (uint32_t tick = 0; tick < inTicks; tick++)
+		ioWriter.Tick();
+
+	ioWriter.SendNoteOn(0, inKey, 100);
+
+	for (uint32_t tick = 0; tick < kStepTicks / 2; tick++)
+		ioWriter.Tick();
+
+	ioWriter.SendNoteOff(0, inKey, 0);
+}
+
+int main(int argc, const char *argv[])
+{
+	char	path[] = "/tmp/SMFImporterTest.XXXXXX";
+	int		file = mkstemp(path);
+
+	if (file < 0)
+	{
+		perror(path);
+		return 1;
+	}
+
+	close(file);
+
+	// three takes, the first step hit by the first track in two of them and by the second in one
+	SMFWriter	writer;
+
+	writer.Open(path, 1, 500000);
+
+	writer.BeginTrack("first");
+	WriteNote(writer, 0, 60);
+	WriteNote(writer, kLoopTicks - kStepTicks / 2, 60);
+	WriteNote(writer, kLoopTicks + kStepTicks * 4 - kStepTicks / 2, 62);
+	writer.EndTrack();
+
+	writer.BeginTrack("second");
+	WriteNote(writer, 0, 64);
+	writer.EndTrack();
+
+	writer.Close();
+
+	SMFImporter	importer;
+	bool				imported = importer.Import(path);
+
+	unlink(path);
+
+	if (!imported)
+	{
+		printf("couldn't import %s\n", path);
+		return 1;
+	}
+
+	Sequence	sequence;
+
+	importer.MakeSequence(sequence);
+
+	const Step	&step(sequence.GetStep(0));
+	uint32_t		chance = step.GetNoteOption(0).mProbability + step.GetNoteOption(1).mProbability;
+
+	printf("first step plays %u%% of the time, %u%% expected\n", chance, 2 * 100 / 3);
+
+	return chance == 2 * 100 / 3 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+// ScalingBench.cpp
+
+// usage: ScalingBench [variations [threads [loops]]]
+// times rendering the same batch of variations of the built in pattern in memory
+// on one thread, then two, and so on up to threads
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// sequencer headers
+
+#include "BatchRenderer.h"
+#include "Sequence.h"
+#include "Sequencer.h"
+
+// times the same batch in memory on 1..inThreadCount threads
+static int
+MeasureScaling(Sequencer &inSequencer, uint64_t inFirstSeed, uint32_t inCount,
+	uint32_t inTicks, uint32_t inThreadCount)
+{
+	double	baseRate = 0;
+
+	printf("threads  variations/s  Mevents/s  speedup\n");
+
+	for (uint32_t threadCount = 1; threadCount <= inThreadCount; threadCount++)
+	{
+		BatchRenderer	renderer(inSequencer.GetSequence(), inSequencer.GetBPM(), inTicks, inSequencer.GetQuantiser());
+
+		std::chrono::steady_clock::time_point	start(std::chrono::steady_clock::now());
+
+		renderer.Render(nullptr, inFirstSeed, inCount, threadCount);
+
+		std::chrono::duration<double>	elapsed(std::chrono::steady_clock::now() - start);
+
+		double	rate = inCount / elapsed.count();
+
+		if (threadCount == 1)
+			baseRate = rate;
+
+		printf("%7u  %12.0f  %9.2f  %7.2f\n", threadCount, rate,
+			renderer.GetEventCount() / elapsed.count() / 1000000.0, rate / baseRate);
+	}
+
+	return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	count = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 1000;
+	uint32_t	threadCount = argc > 2 ? std::max(1ul, strtoul(argv[2], nullptr, 10))
+		: std::max(1u, std::thread::hardware_concurrency());
+	uint32_t	loops = argc > 3 ? std::max(1ul, strtoul(argv[3], nullptr, 10)) : 1;
+
+	std::vector<Sequence>	sequences(1);
+	Sequencer							sequencer;
+
+	sequences[0].SetUpDefault();
+	sequencer.SetSequences(sequences);
+
+	return MeasureScaling(sequencer, 1, count, loops * sequences[0].GetStepCount() * kTicksPerStep, threadCount);
+}
@@ -0,0 +1,87 @@
+// TickRecorder.h
+
+// GUARD
+
+#ifndef TickRecorder_h
+#define TickRecorder_h
+
+// INCLUDES
+
+#include <math.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "HostTime.h"
+#include "SequencerOutput.h"
+
+// CLASS
+
+// a sequencer output that only notes when each tick went off
+class TickRecorder
+	:
+	public SequencerOutput
+{
+	public:
+
+		TickRecorder(uint32_t inCapacity)
+		{
+			mTimes.reserve(inCapacity);
+		}
+
+		void
+		SendNoteOn(Byte inChannel, Byte inKey, Byte inVelocity)
+		{
+		}
+
+		void
+		SendNoteOff(Byte inChannel, Byte inKey, Byte inVelocity)
+		{
+		}
+
+		void
+		Tick()
+		{
+			if (mTimes.size() < mTimes.capacity())
+				mTimes.push_back(HostTime::Now());
+		}
+
+		const std::vector<uint64_t> &
+		GetTimes() const
+		{
+			return mTimes;
+		}
+
+		// only while stopped
+		void
+		Clear()
+		{
+			mTimes.clear();
+		}
+
+	private:
+
+		std::vector<uint64_t>	mTimes;
+};
+
+// standard deviation of the gaps between inTimes, in milliseconds
+inline double
+IntervalDeviation(const std::vector<uint64_t> &inTimes, size_t inFirst)
+{
+	if (inTimes.size() < inFirst + 3)
+		return 0;
+
+	size_t	count = inTimes.size() - inFirst - 1;
+	double	mean = (double) (inTimes.back() - inTimes[inFirst]) / count;
+	double	sum = 0;
+
+	for (size_t i = inFirst; i + 1 < inTimes.size(); i++)
+	{
+		double	deviation = (double) (inTimes[i + 1] - inTimes[i]) - mean;
+		sum += deviation * deviation;
+	}
+
+	return sqrt(sum / count) / 1000000.0;
+}
+
+#endif	// TickRecorder_h
@@ -0,0 +1,136 @@
+// TimingWheelTest.cpp
+
+// usage: TimingWheelTest [events]
+// reschedules events from the handler as they come due, many a whole turn of a level away
+// and cancels others from there, until that many have come due
+// checks each comes due on the tick it was meant to and cancelled ones never do
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+
+// sequencer headers
+
+#include "Random.h"
+#include "TimedEvent.h"
+#include "TimingWheel.h"
+
+static const uint32_t	kEventCount = 100;
+
+// counts each event's arrivals against when it was due
+class WheelChecker
+{
+	public:
+
+		WheelChecker(TimingWheel &inWheel)
+			:
+			mWheel(inWheel),
+			mRandom(1),
+			mTick(0),
+			mDue(0),
+			mFailures(0)
+		{
+			for (uint32_t event = 0; event < kEventCount; event++)
+				Schedule(event);
+		}
+
+		// a tick of the wheel
+		void
+		Advance()
+		{
+			mTick++;
+			mWheel.Advance([this](const TimedEvent &inEvent) { Due(inEvent); });
+		}
+
+		uint32_t
+		GetDueCount() const
+		{
+			return mDue;
+		}
+
+		uint32_t
+		GetFailureCount() const
+		{
+			return mFailures;
+		}
+
+	private:
+
+		void
+		Due(const TimedEvent &inEvent)
+		{
+			uint32_t	event = inEvent.mKey;
+
+			if (!mPending[event] || mTick != mDueTicks[event])
+			{
+				printf("event %u came due on tick %u, %s tick %u\n", event, mTick,
+					mPending[event] ? "meant for" : "cancelled or done by", mDueTicks[event]);
+				mFailures++;
+			}
+
+			mPending[event] = false;
+			mDue++;
+
+			// another one that's waiting, now and then
+			uint32_t	other = mRandom.Below(kEventCount);
+
+			if (mPending[other] && mRandom.Below(4) == 0)
+			{
+				mWheel.Cancel(mHandles[other]);
+				mPending[other] = false;
+
+				Schedule(other);
+			}
+
+			Schedule(event);
+		}
+
+		// a turn of each level, either side of one and anywhere
+		void
+		Schedule(uint32_t inEvent)
+		{
+			static const uint32_t	kTicks[] = { 1, 63, 64, 65, 4095, 4096, 4097 };
+
+			uint32_t	choice = mRandom.Below(sizeof(kTicks) / sizeof(kTicks[0]) + 1);
+			uint32_t	ticks = choice < sizeof(kTicks) / sizeof(kTicks[0]) ? kTicks[choice] : 1 + mRandom.Below(5000);
+
+			TimedEvent	event = { TimedEvent::kNoteOff, 0, (Byte) inEvent, 0, 0 };
+
+			mHandles[inEvent] = mWheel.Schedule(ticks, event);
+			mDueTicks[inEvent] = mTick + ticks;
+			mPending[inEvent] = true;
+		}
+
+		TimingWheel	&mWheel;
+		Random			mRandom;
+
+		// how many times the wheel's gone round
+		uint32_t		mTick;
+
+		uint16_t		mHandles[kEventCount];
+		uint32_t		mDueTicks[kEventCount];
+		bool				mPending[kEventCount];
+
+		uint32_t		mDue;
+		uint32_t		mFailures;
+};
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	events = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 100000;
+
+	TimingWheel		wheel;
+	WheelChecker	checker(wheel);
+
+	while (checker.GetDueCount() < events)
+		checker.Advance();
+
+	printf("%u events came due, %u of them on the wrong tick\n", checker.GetDueCount(), checker.GetFailureCount());
+
+	return checker.GetFailureCount() > 0 ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+// TransportBench.cpp
+
+// usage: TransportBench [cycles]
+// stops and starts the built in pattern that many times
+// and prints how long the transport takes to start, stop and locate
+
+// system headers
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// language headers
+
+#include <algorithm>
+#include <vector>
+
+// sequencer headers
+
+#include "HostTime.h"
+#include "Random.h"
+#include "Sequence.h"
+#include "Sequencer.h"
+#include "TickRecorder.h"
+
+// stops and starts inCycles times, half from the top and half from a random sixteenth
+// and times how long from the call until the first tick ran
+static int
+MeasureTransport(Sequencer &inSequencer, uint32_t inCycles)
+{
+	TickRecorder	recorder(kTicksPerBar);
+	Random				random(1);
+	uint32_t			loopTicks = inSequencer.GetSequence().GetStepCount() * kTicksPerStep;
+
+	double	startTotal = 0;
+	double	startWorst = 0;
+	double	locateTotal = 0;
+	double	stopTotal = 0;
+
+	for (uint32_t cycle = 0; cycle < inCycles; cycle++)
+	{
+		recorder.Clear();
+
+		uint64_t	start = HostTime::Now();
+
+		if (cycle % 2 == 0)
+		{
+			inSequencer.Play(&recorder);
+		}
+		else
+		{
+			uint64_t	locate = HostTime::Now();
+
+			inSequencer.Locate(random.Below(loopTicks));
+
+			locateTotal += HostTime::Now() - locate;
+
+			start = HostTime::Now();
+			inSequencer.Continue();
+		}
+
+		// long enough to be sure of a tick or two
+		HostTime::WaitUntil(start + 50000000);
+
+		uint64_t	stop = HostTime::Now();
+
+		inSequencer.Stop();
+
+		stopTotal += HostTime::Now() - stop;
+
+		if (recorder.GetTimes().size() == 0)
+		{
+			fprintf(stderr, "no ticks after starting\n");
+			return 1;
+		}
+
+		double	latency = recorder.GetTimes()[0] - start;
+
+		startTotal += latency;
+		startWorst = std::max(startWorst, latency);
+	}
+
+	printf("%u starts: first tick %.3fms after the call on average, %.3fms at worst (%.3fms of that is the start gap)\n"
+		"stop returns in %.3fms, locate in %.3fms\n",
+		inCycles, startTotal / inCycles / 1000000.0, startWorst / 1000000.0, kStartGap / 1000000.0,
+		stopTotal / inCycles / 1000000.0, locateTotal / (inCycles / 2) / 1000000.0);
+
+	return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+	uint32_t	cycles = argc > 1 ? std::max(2ul, strtoul(argv[1], nullptr, 10)) : 20;
+
+	std::vector<Sequence>	sequences(1);
+	Sequencer							sequencer;
+
+	sequences[0].SetUpDefault();
+	sequencer.SetSequences(sequences);
+
+	return MeasureTransport(sequencer, cycles);
+}